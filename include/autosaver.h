@@ -0,0 +1,55 @@
+#ifndef AUTOSAVER_H
+#define AUTOSAVER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes a save file on a worker thread, so the thread that asks for a save
+// only hands over the bytes. Each write goes to a temporary file that is
+// flushed to disk and then renamed over the save, so a crash leaves either
+// the old save or the new one, never a torn file. Saves that arrive while a
+// write is running replace each other; only the newest one is written.
+class Autosaver {
+public:
+    Autosaver();
+    ~Autosaver();
+
+    Autosaver(const Autosaver&) = delete;
+    Autosaver& operator=(const Autosaver&) = delete;
+
+    void start(const std::string& savePath);
+    // Writes whatever is still pending, then ends the worker
+    void stop();
+
+    // Queues bytes as the new contents of the save file
+    void save(std::vector<unsigned char> bytes);
+    // Queues deletion of the save file
+    void discard();
+
+    // Reads the save file whole; false when there is none. Call it before
+    // start or between saves, it does not wait for pending writes.
+    static bool load(const std::string& path, std::vector<unsigned char>& bytes);
+
+private:
+    enum class Request {
+        None,
+        Write,
+        Remove
+    };
+
+    std::string path;
+    std::vector<unsigned char> pendingBytes;
+    Request pending;
+    bool stopping;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable requested;
+
+    void workerLoop();
+    bool writeFile(const std::vector<unsigned char>& bytes) const;
+};
+
+#endif // AUTOSAVER_H
@@ -0,0 +1,33 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include <cstddef>
+#include <vector>
+#include "board.h"
+
+struct BatchResult {
+    int solutionCount;  // 0, 1 or 2, where 2 means "more than one"
+    Board solution;     // First solution found, valid when solutionCount > 0
+};
+
+enum class SimdLevel {
+    Scalar,
+    Sse42,
+    Avx2
+};
+
+// Solves many puzzles per call. The whole search runs on several boards at
+// once, one board per 16-bit SIMD lane: naked and hidden single propagation
+// is vectorized, and each lane guesses and backtracks on its own stack. The
+// SIMD path is picked from the CPU at runtime; Scalar solves one puzzle at a
+// time with Solver::countSolutions. Every level gives the same counts.
+class BatchSolver {
+public:
+    static SimdLevel detectSimdLevel();
+    static const char* simdLevelName(SimdLevel level);
+
+    static void solve(const std::vector<Board>& puzzles, std::vector<BatchResult>& results);
+    static void solve(const Board* puzzles, BatchResult* results, std::size_t count, SimdLevel level);
+};
+
+#endif // BATCH_SOLVER_H
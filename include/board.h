@@ -0,0 +1,105 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// (Box*Box)x(Box*Box) grid that keeps an occupancy mask per row, column and box.
+// Bit (n - 1) of a mask is set when digit n is placed somewhere in that unit,
+// so a legality check is one AND and a candidate set is one OR. The mask is
+// the narrowest integer that holds one bit per digit.
+template <int Box>
+class BasicBoard {
+public:
+    typedef typename std::conditional<(Box * Box <= 16), uint16_t, uint32_t>::type Mask;
+
+    static constexpr int SIZE = Box * Box;
+    static constexpr int BOX_SIZE = Box;
+    static constexpr int CELLS = SIZE * SIZE;
+    static constexpr int UNITS = 3 * SIZE;  // rows, then columns, then boxes
+    static constexpr Mask ALL_DIGITS = static_cast<Mask>((1ull << SIZE) - 1);
+
+    BasicBoard();
+
+    int get(int row, int col) const { return cells[row * SIZE + col]; }
+    bool isEmpty(int row, int col) const { return cells[row * SIZE + col] == 0; }
+    int getCell(int cell) const { return cells[cell]; }
+
+    // The cell must be empty and num must be legal there (see canPlace)
+    void place(int row, int col, int num) {
+        Mask mask = bit(num);
+        cells[row * SIZE + col] = static_cast<uint8_t>(num);
+        rowMask[row] |= mask;
+        colMask[col] |= mask;
+        boxMask[boxIndex(row, col)] |= mask;
+    }
+
+    void remove(int row, int col) {
+        Mask mask = static_cast<Mask>(~bit(cells[row * SIZE + col]));
+        cells[row * SIZE + col] = 0;
+        rowMask[row] &= mask;
+        colMask[col] &= mask;
+        boxMask[boxIndex(row, col)] &= mask;
+    }
+
+    bool canPlace(int row, int col, int num) const { return (usedMask(row, col) & bit(num)) == 0; }
+    Mask candidates(int row, int col) const { return ~usedMask(row, col) & ALL_DIGITS; }
+    int candidateCount(int row, int col) const { return popcount(candidates(row, col)); }
+
+    // Digits already placed in a unit, numbered as for unitCell
+    Mask unitMask(int unit) const {
+        if (unit < SIZE) return rowMask[unit];
+        if (unit < 2 * SIZE) return colMask[unit - SIZE];
+        return boxMask[unit - 2 * SIZE];
+    }
+
+    bool findEmptyCell(int& row, int& col) const;
+    int filledCount() const;
+
+    static Mask bit(int num) { return static_cast<Mask>(1u << (num - 1)); }
+    static int boxIndex(int row, int col) { return (row / BOX_SIZE) * BOX_SIZE + col / BOX_SIZE; }
+
+    // Cell index (row * SIZE + col) of the i-th cell of a unit
+    static int unitCell(int unit, int i) {
+        if (unit < SIZE) return unit * SIZE + i;
+        if (unit < 2 * SIZE) return i * SIZE + unit - SIZE;
+        int box = unit - 2 * SIZE;
+        return ((box / BOX_SIZE) * BOX_SIZE + i / BOX_SIZE) * SIZE + (box % BOX_SIZE) * BOX_SIZE + i % BOX_SIZE;
+    }
+
+    static int popcount(Mask mask) {
+#if defined(__GNUC__)
+        return __builtin_popcount(mask);
+#else
+        int count = 0;
+        for (; mask; mask &= mask - 1) count++;
+        return count;
+#endif
+    }
+
+    // Smallest digit whose bit is set in a non-empty mask
+    static int lowestDigit(Mask mask) {
+#if defined(__GNUC__)
+        return __builtin_ctz(mask) + 1;
+#else
+        int num = 1;
+        while (!(mask & 1)) { mask >>= 1; num++; }
+        return num;
+#endif
+    }
+
+private:
+    std::array<uint8_t, CELLS> cells;
+    std::array<Mask, SIZE> rowMask;
+    std::array<Mask, SIZE> colMask;
+    std::array<Mask, SIZE> boxMask;
+
+    Mask usedMask(int row, int col) const {
+        return static_cast<Mask>(rowMask[row] | colMask[col] | boxMask[boxIndex(row, col)]);
+    }
+};
+
+typedef BasicBoard<3> Board;
+
+#endif // BOARD_H
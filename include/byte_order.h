@@ -0,0 +1,29 @@
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <cstdint>
+#include <ostream>
+
+// Little-endian integers of 1-8 bytes, for the binary file formats
+
+inline uint64_t readLE(const unsigned char* bytes, int width) {
+    uint64_t value = 0;
+    for (int i = width - 1; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+inline void writeLE(unsigned char* bytes, uint64_t value, int width) {
+    for (int i = 0; i < width; i++) {
+        bytes[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+inline void writeLE(std::ostream& out, uint64_t value, int width) {
+    for (int i = 0; i < width; i++) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+#endif // BYTE_ORDER_H
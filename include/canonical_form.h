@@ -0,0 +1,33 @@
+#ifndef CANONICAL_FORM_H
+#define CANONICAL_FORM_H
+
+#include <array>
+#include <cstdint>
+#include "board.h"
+
+struct PuzzleHash {
+    uint64_t high;
+    uint64_t low;
+
+    bool operator==(const PuzzleHash& other) const { return high == other.high && low == other.low; }
+    bool operator!=(const PuzzleHash& other) const { return !(*this == other); }
+};
+
+// Minlex canonical form of a 9x9 puzzle: the lexicographically smallest
+// 81-cell string (empty cells as 0) over every transposition, band and
+// in-band row permutation, stack and in-stack column permutation and digit
+// relabeling, i.e. the 2 x 6^8 x 9! symmetry group. Two puzzles are the same
+// up to symmetry exactly when their canonical forms match.
+class CanonicalForm {
+public:
+    typedef std::array<uint8_t, Board::CELLS> Cells;
+
+    static Cells minlex(const Board& puzzle);
+    // 128-bit hash of the canonical form; never all zero
+    static PuzzleHash hash(const Board& puzzle);
+
+private:
+    struct Search;
+};
+
+#endif // CANONICAL_FORM_H
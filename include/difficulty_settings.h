@@ -15,8 +15,13 @@ class DifficultySettings
 public:
     static Slide *getDifficultySlider() { return &difficultySlider; }
 
+    // Box size of the next board: 2, 3, 4 or 5 for 4x4 up to 25x25
+    static int getBoxSize() { return boxSize; }
+    static void setBoxSize(int size) { boxSize = size; }
+
 private:
     static Slide difficultySlider;
+    static int boxSize;
 };
 
 #endif // DIFFICULTY_SETTINGS_H
\ No newline at end of file
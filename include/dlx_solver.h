@@ -0,0 +1,50 @@
+#ifndef DLX_SOLVER_H
+#define DLX_SOLVER_H
+
+#include <vector>
+#include "board.h"
+
+// Knuth's Algorithm X over dancing links. Sudoku maps to an exact cover
+// problem with 4 * CELLS constraint columns (cell, row-digit, column-digit and
+// box-digit) and up to CELLS * SIZE candidate rows, one per (cell, digit)
+// pair: 324 columns and 729 rows for 9x9.
+template <int Box>
+class BasicDlxSolver {
+public:
+    typedef BasicBoard<Box> Board;
+
+    static constexpr int COLUMNS = 4 * Board::CELLS;
+    static constexpr int ROWS = Board::CELLS * Board::SIZE;
+
+    explicit BasicDlxSolver(const Board& board);
+
+    // Same contract as Solver::countSolutions: stop once limit is reached
+    int countSolutions(int limit, Board* solution = nullptr);
+
+private:
+    struct Node {
+        int left, right, up, down;
+        int column;
+        int row;  // cell * SIZE + digit - 1, or -1 for column headers
+    };
+
+    static constexpr int ROOT = COLUMNS;
+
+    std::vector<Node> nodes;
+    std::vector<int> columnSize;
+    std::vector<int> partial;
+    Board givens;
+    int limit;
+    int count;
+    Board* firstSolution;
+
+    void addRow(int row, int col, int num);
+    void cover(int column);
+    void uncover(int column);
+    void search();
+    void recordSolution();
+};
+
+typedef BasicDlxSolver<3> DlxSolver;
+
+#endif // DLX_SOLVER_H
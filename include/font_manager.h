@@ -0,0 +1,44 @@
+#ifndef FONT_MANAGER_H
+#define FONT_MANAGER_H
+
+#include <SDL2/SDL_ttf.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Opens the game's font once per size at startup and hands out the handles,
+// which stay valid until close. The font file is the first one found of:
+//   SUDOKU_FONT        a .ttf path from the environment
+//   assets/fonts       a font bundled next to the game
+//   system fonts       Arial, then DejaVu Sans, then Liberation Sans, looked
+//                      up in the Windows and macOS font folders and in the
+//                      fontconfig directories (XDG, ~/.fonts, /usr/share/fonts)
+// Styles are not part of the handle; set them with TTF_SetFontStyle before use.
+class FontManager {
+public:
+    FontManager();
+    ~FontManager();
+
+    FontManager(const FontManager&) = delete;
+    FontManager& operator=(const FontManager&) = delete;
+
+    // Finds the font and opens every size; false when no candidate opens all
+    // of them. Logs the file and how long it took.
+    bool open(const std::vector<int>& sizes);
+    void close();
+
+    // The font at a size given to open, nullptr for any other size
+    TTF_Font* get(int size) const;
+    const std::string& getPath() const { return path; }
+
+    // Font files to try, in order of preference
+    static std::vector<std::string> candidates();
+
+private:
+    std::string path;
+    std::map<int, TTF_Font*> fonts;
+
+    bool openAll(const std::string& file, const std::vector<int>& sizes);
+};
+
+#endif // FONT_MANAGER_H
@@ -1,11 +1,24 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <future>
+#include <string>
+#include <variant>
 #include "renderer.h"
 #include "sudoku.h"
+#include "puzzle_bank.h"
+#include "puzzle_prefetcher.h"
+#include "move_journal.h"
+#include "hint_engine.h"
+#include "autosaver.h"
+
+// The board being played, one alternative per supported size. 9x9 comes
+// first so a default-constructed game holds the classic board.
+typedef std::variant<Sudoku, BasicSudoku<2>, BasicSudoku<4>, BasicSudoku<5>> AnySudoku;
 
 enum class GameState {
     MENU,
+    GENERATING,  // Waiting for a puzzle from the prefetcher or the generation worker
     PLAYING,
     VICTORY
 };
@@ -21,22 +34,47 @@ public:
     static int getElapsedSeconds() { return currentElapsedSeconds; }
 private:
     Renderer renderer;
-    Sudoku sudoku;
+    AnySudoku sudoku;
+    PuzzleBank puzzleBank;
+    PuzzlePrefetcher prefetcher;  // Declared after the bank so it stops first
+    MoveJournal journal;
+    HintEngine hints;             // Follows the board through the journal
+    std::string journalPath;      // Where finished sessions are captured, empty for nowhere
+    Autosaver autosaver;
+    std::future<AnySudoku> pendingPuzzle;  // Puzzle being generated off the frame thread
+    float pendingDifficulty;      // Of the 9x9 puzzle awaited from the prefetcher
     bool running;
+    bool dirty;                   // Something on screen changed since the last frame
     GameState state;
     int selectedRow;
     int selectedCol;
     Uint32 startTime;
     int elapsedSeconds;
+    bool logFrames;
+    uint64_t frameCount;
+    uint64_t frameWindowCount;    // frameCount when the current log window began
+    Uint32 frameWindowStart;
     bool handleMenuClick(int x, int y);
 
     void handleEvents();
+    void handleEvent(const SDL_Event& event);
     void handleMouseClick(int x, int y);
     void handleKeyPress(SDL_Keycode key);
     void checkWinCondition();
     void updateTimer();
+    int msToNextSecond() const;
+    void countFrame();
+    void startNewPuzzle();
+    void pollPendingPuzzle();
+    void beginPuzzle(AnySudoku board);
+    void returnToMenu();
+    void saveJournal();
+    void autosave();
+    bool restoreSave(const std::vector<unsigned char>& bytes);
+    int gridSize() const;
     
 private:
+    static const int GENERATION_POLL_MS = 50;  // How often the event loop checks on a generating puzzle
     static int currentElapsedSeconds;  // Static member to store current elapsed seconds
 };
 
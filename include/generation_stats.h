@@ -0,0 +1,92 @@
+#ifndef GENERATION_STATS_H
+#define GENERATION_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// What generating one puzzle cost. Filled in only in builds with
+// SUDOKU_ENABLE_STATS (make STATS=1); otherwise the counting macros below
+// expand to nothing and every field stays zero.
+struct GenerationStats {
+    uint64_t nodeVisits;        // Search nodes: grid filling and solution counting
+    uint64_t backtracks;        // Nodes that ran into a dead end
+    uint32_t solutionCounts;    // Solver::countSolutions calls
+    uint32_t ratings;           // LogicalSolver::rate calls
+    uint32_t rejectedRemovals;  // Dug cells put back
+    uint32_t attempts;          // Grids dug
+    int clues;
+    float rating;               // Achieved rating and the window it aimed for
+    float minRating;
+    float maxRating;
+    double fillSeconds;         // Wall time filling solution grids
+    double digSeconds;          // Wall time digging holes
+    double totalSeconds;
+
+#ifdef SUDOKU_ENABLE_STATS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    // Adds other's counters, times and clues; ratings are left alone
+    void merge(const GenerationStats& other);
+    // Writes "label: <stats>" as one line
+    void log(std::ostream& out, const std::string& label) const;
+
+    // Whether every generated Sudoku logs its stats to std::clog
+    static bool isLogging() { return logging; }
+    static void setLogging(bool enabled) { logging = enabled; }
+
+    // Stats the current thread is counting into, or null
+    static GenerationStats*& current() {
+        static thread_local GenerationStats* active = nullptr;
+        return active;
+    }
+
+    // Counts into stats for the rest of the enclosing scope
+    class Scope {
+    public:
+        explicit Scope(GenerationStats& stats) : previous(current()) { current() = &stats; }
+        ~Scope() { current() = previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        GenerationStats* previous;
+    };
+
+    // Adds the wall time of the enclosing scope to one field of the current stats
+    class Timer {
+    public:
+        explicit Timer(double GenerationStats::*field)
+            : stats(current()), field(field), start(std::chrono::steady_clock::now()) {}
+        ~Timer() {
+            if (stats) stats->*field += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    private:
+        GenerationStats* stats;
+        double GenerationStats::*field;
+        std::chrono::steady_clock::time_point start;
+    };
+
+private:
+    static bool logging;
+};
+
+#ifdef SUDOKU_ENABLE_STATS
+#define SUDOKU_STAT_ADD(field, n) \
+    do { if (GenerationStats* statsTarget = GenerationStats::current()) statsTarget->field += (n); } while (0)
+#define SUDOKU_STAT(statement) do { statement; } while (0)
+#define SUDOKU_STAT_SCOPE(stats) GenerationStats::Scope statsScope(stats)
+#define SUDOKU_STAT_TIMER(name, field) GenerationStats::Timer name(&GenerationStats::field)
+#else
+#define SUDOKU_STAT_ADD(field, n) ((void)0)
+#define SUDOKU_STAT(statement) ((void)0)
+#define SUDOKU_STAT_SCOPE(stats) ((void)0)
+#define SUDOKU_STAT_TIMER(name, field) ((void)0)
+#endif
+
+#endif // GENERATION_STATS_H
@@ -0,0 +1,68 @@
+#ifndef HINT_ENGINE_H
+#define HINT_ENGINE_H
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <variant>
+#include "logical_solver.h"
+#include "move_journal.h"
+#include "sudoku.h"
+
+// Suggested next move for the player's board
+template <int Box>
+struct BasicHint {
+    bool mistake;          // (row, col) holds a wrong digit to clear first
+    int row;
+    int col;
+    int digit;             // Digit that belongs at (row, col), 0 for a mistake
+    Technique technique;   // Hardest technique on the way to the placement
+    std::bitset<BasicBoard<Box>::CELLS> support;  // Cells the deduction rests on
+};
+
+// Hints for the game being played, kept beside it rather than in it so a
+// BasicSudoku stays pure game state. The engine holds the candidates of the
+// board made of the givens and the player's correct digits; correct
+// placements are applied as they happen, and clearing a correct digit marks
+// it stale until the next hint. It follows the board as a MoveJournal
+// listener and is rebuilt from grid and solution by reset, e.g. after a load.
+class HintEngine : public MoveListener {
+public:
+    HintEngine();
+
+    // Starts following board; call it whenever the game is replaced
+    template <int Box>
+    void reset(const BasicSudoku<Box>& board);
+    void cellChanged(int cell, int previous, int value) override;
+
+    // Next move for board as the player has it: a wrong digit to clear,
+    // else the next placement the logical solver finds. Eliminations on the
+    // way are kept, so asking again continues where the last hint stopped.
+    // False when the solver is stuck or board is not the one followed.
+    template <int Box>
+    bool findHint(const BasicSudoku<Box>& board, BasicHint<Box>& hint);
+    // Finds a hint and keeps it on show until the board changes
+    template <int Box>
+    bool showHint(const BasicSudoku<Box>& board);
+    // The hint on show, nullptr when there is none
+    template <int Box>
+    const BasicHint<Box>* visibleHint() const;
+
+private:
+    template <int Box>
+    struct State {
+        BasicLogicalSolver<Box> solver;
+        std::array<uint8_t, BasicBoard<Box>::CELLS> solution;
+        bool stale;
+        int wrongCount;  // Player digits that differ from the solution
+        BasicHint<Box> hint;
+        bool visible;
+    };
+
+    std::variant<std::monostate, State<2>, State<3>, State<4>, State<5>> state;
+
+    template <int Box>
+    static void rebuildSolver(State<Box>& engine, const BasicSudoku<Box>& board);
+};
+
+#endif // HINT_ENGINE_H
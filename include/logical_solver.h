@@ -0,0 +1,93 @@
+#ifndef LOGICAL_SOLVER_H
+#define LOGICAL_SOLVER_H
+
+#include <bitset>
+#include <cstdint>
+#include "board.h"
+
+// Deductions the logical solver knows, easiest first. Each one carries a
+// Sudoku Explainer style rating, see LogicalSolver::techniqueRating.
+enum class Technique {
+    HiddenSingleBox,
+    HiddenSingleLine,
+    NakedSingle,
+    Pointing,
+    Claiming,
+    NakedPair,
+    XWing,
+    HiddenPair,
+    NakedTriple,
+    Swordfish,
+    HiddenTriple,
+    XYWing,
+    ForcingChain
+};
+
+// One deduction. A placement puts digit at cell; otherwise every digit in
+// eliminated is removed from every cell in targets.
+template <int Box>
+struct BasicLogicalStep {
+    Technique technique;
+    int cell;                                          // -1 when the step only eliminates
+    int digit;
+    std::bitset<BasicBoard<Box>::CELLS> targets;
+    typename BasicBoard<Box>::Mask eliminated;
+    std::bitset<BasicBoard<Box>::CELLS> support;       // Cells the deduction is based on
+};
+
+// Solves a puzzle the way a person would, always taking the easiest
+// deduction available, and grades it by the hardest one it needed.
+template <int Box>
+class BasicLogicalSolver {
+public:
+    typedef BasicBoard<Box> Board;
+    typedef typename Board::Mask Mask;
+    typedef BasicLogicalStep<Box> LogicalStep;
+
+    // Rating of a puzzle that the technique ladder cannot finish
+    static constexpr float UNSOLVED_RATING = 11.0f;
+
+    explicit BasicLogicalSolver(const Board& board);
+
+    // Finds the easiest deduction rated at most ceiling, applies it and
+    // describes it in step. False when solved or stuck.
+    bool nextStep(LogicalStep& step, float ceiling = UNSOLVED_RATING);
+    // Same search without applying the step
+    bool findStep(LogicalStep& step, float ceiling = UNSOLVED_RATING) const;
+    void apply(const LogicalStep& step);
+    // Places num at cell, which must be one of its candidates, e.g. to follow
+    // a board that is being filled in elsewhere
+    void place(int cell, int num);
+
+    bool isSolved() const { return remaining == 0; }
+    const Board& getBoard() const { return board; }
+    Mask getCandidates(int cell) const { return candidates[cell]; }
+
+    // Hardest technique needed to solve puzzle: 0 for a full grid, and
+    // UNSOLVED_RATING when it needs something harder than ceiling
+    static float rate(const Board& puzzle, float ceiling = UNSOLVED_RATING);
+
+    static float techniqueRating(Technique technique);
+    static const char* techniqueName(Technique technique);
+
+private:
+    Board board;
+    Mask candidates[Board::CELLS];  // Zero for filled cells
+    int remaining;
+
+    bool propagateSingles();
+
+    bool findHiddenSingle(bool boxes, LogicalStep& step) const;
+    bool findNakedSingle(LogicalStep& step) const;
+    bool findIntersection(bool pointing, LogicalStep& step) const;
+    bool findNakedSubset(int size, LogicalStep& step) const;
+    bool findHiddenSubset(int size, LogicalStep& step) const;
+    bool findFish(int size, LogicalStep& step) const;
+    bool findXYWing(LogicalStep& step) const;
+    bool findForcingChain(LogicalStep& step) const;
+};
+
+typedef BasicLogicalStep<3> LogicalStep;
+typedef BasicLogicalSolver<3> LogicalSolver;
+
+#endif // LOGICAL_SOLVER_H
@@ -0,0 +1,83 @@
+#ifndef MOVE_JOURNAL_H
+#define MOVE_JOURNAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "sudoku.h"
+
+// Told about every cell a journal changes, by a move, an undo or a redo
+class MoveListener {
+public:
+    virtual ~MoveListener() {}
+    // cell (row * size + col) went from previous to value
+    virtual void cellChanged(int cell, int previous, int value) = 0;
+};
+
+// Journal of the player's moves on one puzzle, with undo and redo. Moves are
+// appended at a cursor that undo and redo step back and forth, so both are
+// O(1); a new move after an undo drops the undone ones. Each move keeps the score effects it
+// had, so undoing it restores score, accuracy and wrong-answer counts too.
+//
+// Saved journals replay against the game they were recorded on, as a
+// deterministic input workload. File layout (integers little-endian):
+//   header   "SDKJ", u16 version, u8 box size, u8 reserved, u32 move count
+//   start    the game as the first move found it, see BasicSudoku::writeState
+//   moves    u16 cell, u8 previous digit, u8 new digit, u16 ms since the previous move
+class MoveJournal {
+public:
+    struct Move {
+        uint16_t cell;
+        uint16_t delay;    // ms since the previous move, saturating
+        uint8_t previous;
+        uint8_t value;
+        uint8_t effects;   // BasicSudoku::playMove effects; not saved, replay rebuilds them
+    };
+
+    MoveJournal();
+
+    // listener may be null; it is not owned and is kept across start
+    void setListener(MoveListener* moveListener) { listener = moveListener; }
+
+    // Clears the journal and records board as the starting point. ticks is
+    // the current time in ms.
+    template <int Box>
+    void start(const BasicSudoku<Box>& board, uint32_t ticks);
+
+    // Plays the move on board and journals it; false when the cell is a given
+    template <int Box>
+    bool play(BasicSudoku<Box>& board, int row, int col, int num, uint32_t ticks);
+    template <int Box>
+    bool undo(BasicSudoku<Box>& board);
+    template <int Box>
+    bool redo(BasicSudoku<Box>& board);
+
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor < moves.size(); }
+    // Moves in effect, i.e. not undone
+    std::size_t size() const { return cursor; }
+    int getBoxSize() const { return boxSize; }
+
+    // The game as it was at start; false when the journal is for another size
+    template <int Box>
+    bool startingBoard(BasicSudoku<Box>& board) const;
+    // Plays every move in effect onto board, which should be the starting
+    // board, and leaves the journal ready to undo them. False when a move
+    // does not fit the board.
+    template <int Box>
+    bool replay(BasicSudoku<Box>& board);
+
+    // Writes the moves in effect
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+private:
+    std::vector<Move> moves;
+    std::size_t cursor;
+    int boxSize;
+    std::vector<unsigned char> startState;
+    uint32_t lastTicks;
+    MoveListener* listener;
+};
+
+#endif // MOVE_JOURNAL_H
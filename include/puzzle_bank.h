@@ -0,0 +1,75 @@
+#ifndef PUZZLE_BANK_H
+#define PUZZLE_BANK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "board.h"
+
+struct BankEntry {
+    int bucket;
+    Board puzzle;
+    Board solution;
+};
+
+// Read-only, memory-mapped file of pre-generated puzzles grouped into
+// difficulty buckets over the slider range.
+//
+// Layout (all integers little-endian):
+//   header   "SDKB", u16 version, u16 bucket count, u32 record size, u32 reserved
+//   buckets  u64 offset of the first record, u64 record count, per bucket
+//   records  puzzle then solution, each 81 cells packed two per byte
+//
+// Opening only maps the file and reads the bucket table, so startup cost does
+// not depend on how many puzzles the bank holds.
+class PuzzleBank {
+public:
+    static const int BUCKETS = 10;
+    static const int PACKED_BOARD_SIZE = (Board::CELLS + 1) / 2;
+    static const int RECORD_SIZE = 2 * PACKED_BOARD_SIZE;
+
+    PuzzleBank();
+    ~PuzzleBank();
+
+    PuzzleBank(const PuzzleBank&) = delete;
+    PuzzleBank& operator=(const PuzzleBank&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    // Hands out a not yet used record of the difficulty's bucket in O(1).
+    // Records that are not a valid puzzle of their solution are skipped.
+    // Returns false when the bank is not open or the bucket is exhausted.
+    bool take(float difficulty, Board& puzzle, Board& solution);
+    std::size_t remaining(int bucket) const;
+
+    static int bucketFor(float difficulty);
+    static float bucketDifficulty(int bucket);  // Slider value at the bucket's center
+    static bool write(const std::string& path, const std::vector<BankEntry>& entries);
+
+private:
+    // Records of a bucket are visited as start + i * stride (mod count), with
+    // stride coprime to count, so every record is served once in a shuffled order
+    struct Bucket {
+        uint64_t offset;
+        uint64_t count;
+        uint64_t start;
+        uint64_t stride;
+        uint64_t served;
+    };
+
+    const unsigned char* data;
+    std::size_t size;
+    std::vector<Bucket> buckets;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    bool mapFile(const std::string& path);
+    void unmapFile();
+};
+
+#endif // PUZZLE_BANK_H
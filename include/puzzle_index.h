@@ -0,0 +1,48 @@
+#ifndef PUZZLE_INDEX_H
+#define PUZZLE_INDEX_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "canonical_form.h"
+
+// Set of canonical puzzle hashes for rejecting puzzles that are the same up
+// to symmetry. Open addressing with linear probing over a power-of-two table
+// of bare 128-bit hashes (16 bytes a slot, the all-zero hash marking an empty
+// one), grown at 3/4 load, so tens of millions of entries fit in well under
+// 2 GB. Safe to share between generator threads.
+class PuzzleIndex {
+public:
+    explicit PuzzleIndex(std::size_t expected = 0);
+
+    PuzzleIndex(const PuzzleIndex&) = delete;
+    PuzzleIndex& operator=(const PuzzleIndex&) = delete;
+
+    // Adds hash; false when it was already there
+    bool insert(const PuzzleHash& hash);
+    bool contains(const PuzzleHash& hash) const;
+    void reserve(std::size_t expected);
+    void clear();
+
+    std::size_t size() const;
+    // Inserts turned away because the puzzle was already indexed
+    std::size_t duplicates() const;
+
+    // Index that Sudoku generation checks its 9x9 puzzles against, or null
+    // for no duplicate checks. Set it before generation threads start.
+    static PuzzleIndex* generationIndex() { return activeIndex; }
+    static void setGenerationIndex(PuzzleIndex* index) { activeIndex = index; }
+
+private:
+    std::vector<PuzzleHash> slots;
+    std::size_t count;
+    std::size_t rejected;
+    mutable std::mutex mutex;
+
+    static PuzzleIndex* activeIndex;
+
+    std::size_t findSlot(const PuzzleHash& hash) const;
+    void rehash(std::size_t capacity);
+};
+
+#endif // PUZZLE_INDEX_H
@@ -0,0 +1,56 @@
+#ifndef PUZZLE_PREFETCHER_H
+#define PUZZLE_PREFETCHER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "puzzle_bank.h"
+#include "sudoku.h"
+
+// Keeps ready puzzles for every difficulty bucket, produced on a worker
+// thread from the puzzle bank or by live generation, so the UI thread only
+// moves a finished puzzle out instead of generating one.
+class PuzzlePrefetcher {
+public:
+    explicit PuzzlePrefetcher(int depth = 1);  // Ready puzzles kept per bucket
+    ~PuzzlePrefetcher();
+
+    PuzzlePrefetcher(const PuzzlePrefetcher&) = delete;
+    PuzzlePrefetcher& operator=(const PuzzlePrefetcher&) = delete;
+
+    // bank may be null; once started, only the worker thread touches it
+    void start(PuzzleBank* bank);
+    void stop();
+
+    // The bucket of this difficulty is refilled before all others
+    void setDifficulty(float difficulty);
+    // Moves out a ready puzzle. Blocks only if that bucket is still cold,
+    // e.g. right after startup; without a worker it generates inline.
+    Sudoku take(float difficulty);
+    // Moves out a ready puzzle if that bucket has one and returns false at
+    // once otherwise, asking the worker to fill it first. Never waits, so
+    // the UI thread calls it until it succeeds; without a worker it
+    // generates inline.
+    bool tryTake(float difficulty, Sudoku& puzzle);
+    std::size_t readyCount(float difficulty) const;
+
+private:
+    std::vector<std::deque<Sudoku>> ready;
+    PuzzleBank* bank;
+    int depth;
+    float preferredDifficulty;
+    bool stopping;
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable workNeeded;
+    std::condition_variable puzzleReady;
+
+    void workerLoop();
+    int nextBucketToFill() const;
+    Sudoku makePuzzle(float difficulty);
+};
+
+#endif // PUZZLE_PREFETCHER_H
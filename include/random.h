@@ -0,0 +1,68 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <utility>
+
+// xoshiro256** seeded through splitmix64. Small, fast and fully determined by
+// its 64-bit seed, so one generator owned by a generation run makes the run
+// reproducible from that seed alone.
+class Random {
+public:
+    explicit Random(uint64_t seed) {
+        for (uint64_t& word : state) {
+            word = splitmix64(seed);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [0, bound), bound > 0 (Lemire's multiply-shift with rejection)
+    uint32_t nextInt(uint32_t bound) {
+        uint64_t product = (next() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // Fisher-Yates shuffle. Unlike std::shuffle its output does not depend on
+    // the standard library, so a seed means the same thing on every platform.
+    template <typename Iterator>
+    void shuffle(Iterator first, Iterator last) {
+        for (auto count = last - first; count > 1; count--) {
+            std::swap(first[count - 1], first[nextInt(static_cast<uint32_t>(count))]);
+        }
+    }
+
+    // Advances x and returns the next splitmix64 output, also handy for
+    // deriving well-spread seeds from consecutive IDs
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif // RANDOM_H
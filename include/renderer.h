@@ -4,15 +4,20 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
+#include <array>
 #include <string>
 #include "sudoku.h"
+#include "hint_engine.h"
 #include "difficulty_settings.h"
+#include "text_cache.h"
+#include "font_manager.h"
 
 class Renderer {
 public:
     static const int CELL_SIZE = 60;
-    static const int WINDOW_WIDTH = CELL_SIZE * Sudoku::GRID_SIZE;
-    static const int WINDOW_HEIGHT = CELL_SIZE * Sudoku::GRID_SIZE + 100; // Increased height to accommodate score display
+    static const int GRID_PIXELS = CELL_SIZE * Sudoku::GRID_SIZE;  // Every board size is fitted into the 9x9 area
+    static const int WINDOW_WIDTH = GRID_PIXELS;
+    static const int WINDOW_HEIGHT = GRID_PIXELS + 100; // Increased height to accommodate score display
     
     enum class Theme {
         Light,
@@ -26,13 +31,20 @@ public:
     ~Renderer();
     
     bool init();
-    void render(const Sudoku& sudoku, int selectedRow = -1, int selectedCol = -1);
+    // hint, when given, is highlighted on the board
+    template <int Box>
+    void render(const BasicSudoku<Box>& sudoku, int selectedRow = -1, int selectedCol = -1,
+                const BasicHint<Box>* hint = nullptr);
     void renderMessage(const std::string& message);
-    void getGridPosition(int mouseX, int mouseY, int& row, int& col);
+    // A blank screen with message, for waits like puzzle generation, and a
+    // note that Esc leaves it
+    void renderWaitScreen(const std::string& message);
+    void getGridPosition(int mouseX, int mouseY, int gridSize, int& row, int& col);
     void close();
     void renderScore(int score);
     void renderTimer(int elapsedSeconds);
     void renderVictoryScreen(int score, int elapsedSeconds);
+    // 1 for New Game, 2 for Main Menu, 3 for Exit, 0 for a click on no button
     int handleVictoryScreenClick(int x, int y);
     void renderHighGammaEffect();
     void renderMenuScreen();
@@ -42,23 +54,79 @@ public:
     bool handleMenuClick(int x, int y);
     void renderDifficultySlider();
     void updateDifficultySlider(int mouseX);
+    const TextCache& getTextCache() const { return textCache; }
     
 private:
     SDL_Window* window;
     SDL_Renderer* renderer;
+    static const int FONT_SIZE = 24;
+    static const int SMALL_FONT_SIZE = 14;
+    static const int TITLE_FONT_SIZE = 72;
+    static const int SUBTITLE_FONT_SIZE = 16;
+    FontManager fonts;    // Every size above, opened once at init
     TTF_Font* font;
+    TTF_Font* smallFont;  // Hint text, and the glyphs of 16x16 and larger boards
+    TTF_Font* titleFont;
+    TTF_Font* subtitleFont;
     static SDL_Texture *cachedBackground;
     static SDL_Texture *resetTexture;
     Theme currentTheme = Theme::Light; // Default to light theme
-    
-    void renderGrid();
-    void renderNumbers(const Sudoku& sudoku);
-    void renderSelectedCell(int row, int col);
-    void renderNumber(int number, int row, int col, bool isFixed, const Sudoku& sudoku);
-    void renderNumberCounts(const Sudoku& sudoku);
-    void renderHighlightedNumbers(const Sudoku& sudoku, int highlightedNumber);
-    std::array<int, 9> calculateNumberCounts(const Sudoku& sudoku) const;
+
+    // Board symbols are rasterized once at init into a single atlas texture,
+    // one glyph per face, ink and symbol, so each digit on screen is one copy
+    enum GlyphFace {
+        FACE_REGULAR,
+        FACE_BOLD,
+        FACE_SMALL_REGULAR,  // smallFont, for 16x16 and larger boards
+        FACE_SMALL_BOLD,
+        FACE_COUNT
+    };
+    enum GlyphInk {
+        INK_FIXED_LIGHT,
+        INK_EDITABLE_LIGHT,
+        INK_FIXED_DARK,
+        INK_EDITABLE_DARK,
+        INK_WRONG,
+        INK_COUNT_LIGHT,       // Number count bar, digit still missing somewhere
+        INK_COUNT_DONE_LIGHT,  // Number count bar, digit placed everywhere
+        INK_COUNT_DARK,
+        INK_COUNT_DONE_DARK,
+        INK_COUNT
+    };
+    static const int GLYPH_SYMBOLS = 26;  // 0-9 and A-P, enough for 25x25
+    SDL_Texture* glyphAtlas;
+    std::array<SDL_Rect, FACE_COUNT * INK_COUNT * GLYPH_SYMBOLS> glyphRects;
+    TextCache textCache;  // Labels, score, timer and other free text
+
+    static int cellSize(int gridSize) { return GRID_PIXELS / gridSize; }
+    // 1-9, then A, B, ... for the larger boards
+    static std::string symbolText(int number);
+    static GlyphFace boardFace(int gridSize, bool bold) {
+        return gridSize > Sudoku::GRID_SIZE ? (bold ? FACE_SMALL_BOLD : FACE_SMALL_REGULAR) : (bold ? FACE_BOLD : FACE_REGULAR);
+    }
+
+    bool buildGlyphAtlas();
+    const SDL_Rect* glyphRect(GlyphFace face, GlyphInk ink, char symbol) const;
+    // Draws text made of atlas symbols from its top-left corner, each glyph
+    // scaled by 1/divisor; returns the width drawn
+    int renderGlyphs(const std::string& text, int x, int y, GlyphFace face, GlyphInk ink, int divisor = 1);
+
+    void renderGrid(int boxSize);
+    void renderSelectedCell(int row, int col, int boxSize);
+    template <int Box>
+    void renderNumbers(const BasicSudoku<Box>& sudoku);
+    template <int Box>
+    void renderNumber(int number, int row, int col, bool isFixed, const BasicSudoku<Box>& sudoku);
+    template <int Box>
+    void renderNumberCounts(const BasicSudoku<Box>& sudoku);
+    template <int Box>
+    void renderHighlightedNumbers(const BasicSudoku<Box>& sudoku, int highlightedNumber);
+    template <int Box>
+    void renderHint(const BasicHint<Box>& hint);
     void renderText(const std::string& text, int x, int y, SDL_Color color);
+    void renderText(TTF_Font* textFont, const std::string& text, int x, int y, SDL_Color color);
+    // Size of text as renderText draws it, {0, 0} when it cannot be rendered
+    SDL_Point textSize(TTF_Font* textFont, const std::string& text, SDL_Color color);
 };
 
 #endif // RENDERER_H
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <cstdint>
+#include <string>
+#include "board.h"
+
+class ThreadPool;
+
+enum class SolverBackend {
+    Backtracking,
+    DancingLinks
+};
+
+// Entry point for solution counting and solving. The backend is chosen at
+// runtime so the two implementations can be compared on the same puzzles.
+// Every board size gets its own instantiation of both backends.
+class Solver {
+public:
+    static SolverBackend getBackend() { return backend; }
+    static void setBackend(SolverBackend newBackend) { backend = newBackend; }
+    static bool parseBackend(const std::string& name, SolverBackend& result);
+    static const char* backendName(SolverBackend backend);
+
+    // Counts solutions of board, stopping as soon as limit is reached.
+    // The first solution found is written to solution when it is given.
+    template <int Box>
+    static int countSolutions(const BasicBoard<Box>& board, int limit, BasicBoard<Box>* solution = nullptr);
+    template <int Box>
+    static bool solve(BasicBoard<Box>& board);
+    // True when board has a solution that puts a digit other than num at the
+    // empty cell (row, col). Cheaper than a full count when one solution is known.
+    template <int Box>
+    static bool hasAlternative(const BasicBoard<Box>& board, int row, int col, int num);
+    // Exact count up to limit, for limits in the millions. The search tree is
+    // split into tasks on pool whenever its queues run low, and every task
+    // stops once the shared count reaches limit. Always uses backtracking;
+    // call it from outside pool's workers.
+    template <int Box>
+    static uint64_t countSolutionsParallel(const BasicBoard<Box>& board, uint64_t limit, ThreadPool& pool);
+
+private:
+    static SolverBackend backend;
+
+    // Branch nodes deeper than this always run on the task that reached them
+    static constexpr int MAX_SPLIT_DEPTH = 24;
+    // Solutions a task finds before adding them to the shared count
+    static constexpr uint64_t COUNT_BATCH = 64;
+
+    struct ParallelCount;
+
+    template <int Box>
+    static int countBacktracking(BasicBoard<Box> board, int limit, int count, BasicBoard<Box>* solution);
+    template <int Box>
+    static bool propagateSingles(BasicBoard<Box>& board);
+    // Empty cell with the fewest candidates; false when the board is full
+    template <int Box>
+    static bool findBranchCell(const BasicBoard<Box>& board, int& row, int& col);
+    template <int Box>
+    static void spawnCount(ParallelCount& shared, const BasicBoard<Box>& board, int depth);
+    template <int Box>
+    static void countParallelNode(ParallelCount& shared, BasicBoard<Box> board, int depth, uint64_t& found);
+};
+
+#endif // SOLVER_H
@@ -1,18 +1,61 @@
 #ifndef SUDOKU_H
 #define SUDOKU_H
 
-#include <vector>
-#include <random>
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <algorithm>
+#include "board.h"
+#include "random.h"
+#include "logical_solver.h"
+#include "generation_stats.h"
 
-class Sudoku {
+// A game on a (Box*Box)x(Box*Box) board. Each supported size (see the explicit
+// instantiations in sudoku.cpp) is compiled separately, so grid sizes, mask
+// widths and loop bounds are all constants in the generated code.
+template <int Box>
+class BasicSudoku {
 public:
-    static const int GRID_SIZE = 9;
-    static const int SUBGRID_SIZE = 3;
+    typedef BasicBoard<Box> Board;
+    typedef typename Board::Mask Mask;
+    typedef BasicLogicalSolver<Box> LogicalSolverType;
+
+    static constexpr int GRID_SIZE = Board::SIZE;
+    static constexpr int SUBGRID_SIZE = Box;
+    static constexpr int CELL_COUNT = Board::CELLS;
+
+    BasicSudoku();  // Empty board, nothing generated
+    // difficulty uses the 0-1 scale of the menu slider (0 = hard, 1 = easy)
+    explicit BasicSudoku(float difficulty);
+    // Same ID and difficulty always give the same puzzle
+    BasicSudoku(float difficulty, uint64_t puzzleId);
+    // Starts a game on an existing puzzle; its non-empty cells become the givens
+    BasicSudoku(const Board& puzzle, const Board& answer, float difficulty);
+    // Score effects a move can have, as reported by playMove
+    static constexpr uint8_t MOVE_CORRECT = 1;        // correctInputs and +5
+    static constexpr uint8_t MOVE_SCORED = 2;         // First correct digit in the cell
+    static constexpr uint8_t MOVE_BONUS_SHIFT = 2;    // Completed units, 0-3, in bits 2-3
+    static constexpr uint8_t MOVE_WRONG = 16;         // Difficulty penalty
+    static constexpr uint8_t MOVE_WRONG_COUNTED = 32; // wrong_answers went up (it saturates)
 
-    Sudoku();
     bool setNumber(int row, int col, int num);
+    // setNumber that also reports the move's score effects, so revertMove
+    // can take it back exactly
+    bool playMove(int row, int col, int num, uint8_t& effects);
+    // Undoes the latest playMove at (row, col), which replaced previous
+    void revertMove(int row, int col, int previous, uint8_t effects);
     int getNumber(int row, int col) const;
+    int getSolution(int row, int col) const { return solution[cellIndex(row, col)]; }
+    float getDifficulty() const { return difficulty; }
+    // Hardest technique the puzzle needs, see LogicalSolver::rate
+    float getRating() const { return rating; }
+    // Seed the puzzle was generated from, 0 when it did not come from generation
+    uint64_t getPuzzleId() const { return puzzleId; }
+#ifdef SUDOKU_ENABLE_STATS
+    // What generating the puzzle cost; only in builds with STATS=1, so that
+    // other builds carry no counters in every session
+    const GenerationStats& getGenerationStats() const { return stats; }
+#endif
     bool isCellEditable(int row, int col) const;
     bool isSolved() const;
     int getScore() const { return score; }
@@ -27,38 +70,84 @@ public:
 
     bool isValid(int row, int col, int num) const;
     bool isHighlightVisible() const { return highlightedVisible; }
+
+    // Aggregates kept up to date by setNumber, so none of these scan the board
+    int getDigitCount(int num) const { return digitCount[num - 1]; }
+    // (row, col) holds a digit that also appears elsewhere in one of its units
+    bool hasConflict(int row, int col) const { return conflicts[cellIndex(row, col)]; }
+    // Every cell of the unit holds its solution digit
+    bool isRowComplete(int row) const { return rowCorrect[row] == GRID_SIZE; }
+    bool isColumnComplete(int col) const { return colCorrect[col] == GRID_SIZE; }
+    bool isBoxComplete(int box) const { return boxCorrect[box] == GRID_SIZE; }
     int getHighlightedNumber() const { return highlightedNumber; }
 
+    // Game state for save files: difficulty, rating, puzzle ID, score and
+    // accuracy counters (little-endian), then grid, solution, wrong-answer
+    // counts and fixed/scored flags, one byte per cell each
+    static constexpr std::size_t STATE_SIZE = 28 + 4 * CELL_COUNT;
+    void writeState(unsigned char* bytes) const;
+    // False, leaving the game untouched, when bytes do not hold a consistent game
+    bool readState(const unsigned char* bytes);
+
 private:
-    std::vector<std::vector<int>> grid;
-    std::vector<std::vector<int>> solution;
-    std::vector<std::vector<bool>> fixed;
-    std::vector<std::vector<bool>> scored;
-    std::vector<std::vector<int>> wrong_answers;
+    // Cell state is stored flat, indexed row * GRID_SIZE + col, and sized at
+    // compile time so a whole game copies with a single memcpy
+    std::array<uint8_t, CELL_COUNT> grid;
+    std::array<uint8_t, CELL_COUNT> solution;
+    std::bitset<CELL_COUNT> fixed;
+    std::bitset<CELL_COUNT> scored;
+    std::array<uint8_t, CELL_COUNT> wrong_answers;  // Saturates at 255
+    float difficulty;
+    float rating;
+    uint64_t puzzleId;
     int score;
     int correctInputs;
     int totalAttempts;
     int highlightedNumber;
     bool highlightedVisible;
 
+    // Occupancy masks over the player grid: bit (n - 1) of a unit mask is set
+    // while digit n appears in that unit, and its dup mask while it appears twice
+    std::array<Mask, GRID_SIZE> rowMask;
+    std::array<Mask, GRID_SIZE> colMask;
+    std::array<Mask, GRID_SIZE> boxMask;
+    std::array<Mask, GRID_SIZE> rowDupMask;
+    std::array<Mask, GRID_SIZE> colDupMask;
+    std::array<Mask, GRID_SIZE> boxDupMask;
+
+    // Cells per unit holding their solution digit, cells per digit, filled
+    // cells, and cells whose digit clashes with another in one of its units
+    std::array<uint8_t, GRID_SIZE> rowCorrect;
+    std::array<uint8_t, GRID_SIZE> colCorrect;
+    std::array<uint8_t, GRID_SIZE> boxCorrect;
+    std::array<uint16_t, GRID_SIZE> digitCount;
+    int filledCount;
+    std::bitset<CELL_COUNT> conflicts;
+#ifdef SUDOKU_ENABLE_STATS
+    GenerationStats stats;
+#endif
+
+    static int cellIndex(int row, int col) { return row * GRID_SIZE + col; }
+
+    // Whole grids dug before settling for the closest rating
+    static constexpr int MAX_GENERATION_ATTEMPTS = 20;
+
+    static uint64_t randomPuzzleId();
     void generatePuzzle();
-    bool solveGrid();
-    bool findEmptyCell(int &row, int &col) const;
-    void removeCells();
-    int countSolutions(int count);
-    bool isValidInRow(int row, int num) const;
-    bool isValidInCol(int col, int num) const;
-    bool isValidInBox(int startRow, int startCol, int num) const;
+    float removeCells(Board& puzzle, float maxRating, Random& rng);
+    static void ratingRange(float difficulty, float& minRating, float& maxRating);
+    void rebuildAggregates();
+    void writeCell(int row, int col, int num);
+    void markDigit(int row, int col, int num);
+    void refreshDigit(int row, int col, int num);
+    void refreshConflicts(int row, int col, int num);
+    int duplicateUnits(int row, int col, int num) const;
+    void countCell(int row, int col, int num, int delta);
     void initializeScore();
-    bool isRowComplete(int row) const;
-    bool isColumnComplete(int col) const;
-    bool isBoxComplete(int startRow, int startCol) const;
     int getPenaltyForDifficulty() const;
     float getAccuracyPercentage() const;
-private:
-    bool findEmptyCellInGrid(const std::vector<std::vector<int>>& checkGrid, int& row, int& col) const;
-    bool isValidInGrid(const std::vector<std::vector<int>>& checkGrid, int row, int col, int num) const;
-    int countSolutionsRecursive(std::vector<std::vector<int>>& checkGrid, int count);
 };
 
+typedef BasicSudoku<3> Sudoku;
+
 #endif // SUDOKU_H
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Rendered text textures, keyed by font, font style, string and color, so
+// text that does not change between frames is rasterized and uploaded once.
+// Entries are evicted least recently used first once their pixels exceed the
+// byte budget. Textures belong to the SDL_Renderer they were made with; clear
+// the cache before destroying it.
+class TextCache {
+public:
+    static const std::size_t DEFAULT_BUDGET = 2 * 1024 * 1024;
+
+    struct Entry {
+        SDL_Texture* texture;
+        int width;
+        int height;
+    };
+
+    explicit TextCache(std::size_t byteBudget = DEFAULT_BUDGET);
+    ~TextCache();
+
+    TextCache(const TextCache&) = delete;
+    TextCache& operator=(const TextCache&) = delete;
+
+    // The texture of text in font's current style, rendering it on a miss.
+    // nullptr when it cannot be rendered. Valid until the next get or clear.
+    const Entry* get(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color);
+    void clear();
+
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+    uint64_t getEvictions() const { return evictions; }
+    std::size_t getBytes() const { return bytes; }
+    std::size_t size() const { return entries.size(); }
+
+private:
+    struct Key {
+        TTF_Font* font;
+        int style;
+        uint32_t color;
+        std::string text;
+
+        bool operator==(const Key& other) const {
+            return font == other.font && style == other.style && color == other.color && text == other.text;
+        }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+    struct Node {
+        Key key;
+        Entry entry;
+        std::size_t bytes;
+    };
+
+    std::size_t budget;
+    std::size_t bytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    std::list<Node> entries;  // Most recently used first
+    std::unordered_map<Key, std::list<Node>::iterator, KeyHash> index;
+
+    void evictLast();
+};
+
+#endif // TEXT_CACHE_H
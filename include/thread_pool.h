@@ -0,0 +1,56 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool where every worker owns a task deque. Workers pop their own
+// newest task first and steal the oldest task from another worker when idle,
+// so tasks that spawn subtasks keep their work local until someone is starved.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount = 0);  // 0 = one per hardware thread
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Called from a worker, the task lands on that worker's own deque
+    void submit(std::function<void()> task);
+    // Blocks until every submitted task, including ones spawned by tasks, has run
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+    // Tasks waiting in the deques, a snapshot for deciding whether to split work
+    std::size_t queuedTasks() const { return queued.load(std::memory_order_relaxed); }
+    // Index of the calling worker thread, or -1 outside this pool
+    int currentWorker() const;
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<std::size_t> queued;
+    std::atomic<std::size_t> pending;
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+
+    void workerLoop(unsigned index);
+    bool takeTask(unsigned index, std::function<void()>& task);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,104 @@
+#include "autosaver.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+Autosaver::Autosaver() : pending(Request::None), stopping(false) {}
+
+Autosaver::~Autosaver() {
+    stop();
+}
+
+void Autosaver::start(const std::string& savePath) {
+    if (worker.joinable()) return;
+    path = savePath;
+    stopping = false;
+    worker = std::thread(&Autosaver::workerLoop, this);
+}
+
+void Autosaver::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    requested.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void Autosaver::save(std::vector<unsigned char> bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingBytes.swap(bytes);
+        pending = Request::Write;
+    }
+    requested.notify_one();
+}
+
+void Autosaver::discard() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingBytes.clear();
+        pending = Request::Remove;
+    }
+    requested.notify_one();
+}
+
+bool Autosaver::load(const std::string& path, std::vector<unsigned char>& bytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+void Autosaver::workerLoop() {
+    std::vector<unsigned char> bytes;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        requested.wait(lock, [this] { return stopping || pending != Request::None; });
+        if (pending == Request::None) return;  // Stopping with nothing left to write
+
+        Request request = pending;
+        pending = Request::None;
+        bytes.swap(pendingBytes);
+        lock.unlock();
+        if (request == Request::Write) {
+            writeFile(bytes);
+        } else {
+            std::remove(path.c_str());
+        }
+        lock.lock();
+    }
+}
+
+bool Autosaver::writeFile(const std::vector<unsigned char>& bytes) const {
+    std::string temp = path + ".tmp";
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() && std::fflush(file) == 0;
+    // On disk before the rename makes it the save
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    return MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+}
@@ -0,0 +1,269 @@
+#include "batch_solver.h"
+#include "solver.h"
+#include <array>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SUDOKU_BATCH_SIMD 1
+#endif
+
+#ifdef SUDOKU_BATCH_SIMD
+
+// Unit indices (row, column, box) of every cell and cell indices of every unit
+struct UnitTables {
+    int cellUnits[Board::CELLS][3];
+    int unitCells[Board::UNITS][Board::SIZE];
+
+    UnitTables() {
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            int row = cell / Board::SIZE, col = cell % Board::SIZE;
+            cellUnits[cell][0] = row;
+            cellUnits[cell][1] = Board::SIZE + col;
+            cellUnits[cell][2] = 2 * Board::SIZE + Board::boxIndex(row, col);
+        }
+        for (int unit = 0; unit < Board::UNITS; unit++) {
+            for (int i = 0; i < Board::SIZE; i++) {
+                unitCells[unit][i] = Board::unitCell(unit, i);
+            }
+        }
+    }
+};
+
+static const UnitTables tables;
+
+// GCC vector types cannot take a dependent size, so each lane count gets its own
+template <int Lanes> struct LaneVector;
+template <> struct LaneVector<8> { typedef uint16_t Type __attribute__((vector_size(16))); };
+template <> struct LaneVector<16> { typedef uint16_t Type __attribute__((vector_size(32))); };
+
+// Naked and hidden single propagation on Lanes boards at once. candidates is
+// laid out [cell][lane]; a lane is marked dead once it hits a contradiction.
+template <int Lanes>
+__attribute__((always_inline)) inline void propagateLanes(uint16_t (*candidates)[Lanes], bool* dead) {
+    typedef typename LaneVector<Lanes>::Type Vec;
+
+    Vec cand[Board::CELLS];
+    std::memcpy(cand, candidates, sizeof(cand));
+
+    const Vec zero = {};
+    const Vec all = zero + Board::ALL_DIGITS;
+    Vec deadLanes = zero;
+
+    for (int pass = 0; pass < Board::CELLS; pass++) {
+        // Digits solved in each unit, and digits solved twice (a contradiction)
+        Vec solved[Board::UNITS], clash[Board::UNITS];
+        for (int unit = 0; unit < Board::UNITS; unit++) {
+            solved[unit] = zero;
+            clash[unit] = zero;
+        }
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            Vec c = cand[cell];
+            Vec single = c & (Vec)((c & (c - 1)) == 0);
+            for (int unit : tables.cellUnits[cell]) {
+                clash[unit] |= solved[unit] & single;
+                solved[unit] |= single;
+            }
+        }
+
+        // Naked singles: strip solved peers' digits from unsolved cells
+        Vec changed = zero;
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            const int* units = tables.cellUnits[cell];
+            Vec c = cand[cell];
+            Vec unsolved = (Vec)((c & (c - 1)) != 0);
+            Vec peers = solved[units[0]] | solved[units[1]] | solved[units[2]];
+            Vec next = c & ~(peers & unsolved);
+            changed |= next ^ c;
+            cand[cell] = next;
+        }
+
+        // Hidden singles: a digit with one place left in a unit goes there
+        for (int unit = 0; unit < Board::UNITS; unit++) {
+            Vec once = zero, twice = zero;
+            for (int i = 0; i < Board::SIZE; i++) {
+                Vec c = cand[tables.unitCells[unit][i]];
+                twice |= once & c;
+                once |= c;
+            }
+            deadLanes |= (Vec)(once != all) | clash[unit];
+
+            Vec hidden = once & ~twice;
+            for (int i = 0; i < Board::SIZE; i++) {
+                int cell = tables.unitCells[unit][i];
+                Vec c = cand[cell];
+                Vec hit = c & hidden;
+                Vec take = (Vec)(hit != 0);
+                Vec next = (hit & take) | (c & ~take);
+                changed |= next ^ c;
+                cand[cell] = next;
+            }
+        }
+
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            deadLanes |= (Vec)(cand[cell] == 0);
+        }
+
+        bool progress = false;
+        for (int lane = 0; lane < Lanes; lane++) {
+            if (changed[lane] != 0 && deadLanes[lane] == 0) progress = true;
+        }
+        if (!progress) break;
+    }
+
+    std::memcpy(candidates, cand, sizeof(cand));
+    for (int lane = 0; lane < Lanes; lane++) {
+        dead[lane] = deadLanes[lane] != 0;
+    }
+}
+
+__attribute__((target("avx2"))) static void propagateAvx2(uint16_t (*candidates)[16], bool* dead) {
+    propagateLanes<16>(candidates, dead);
+}
+
+__attribute__((target("sse4.2"))) static void propagateSse42(uint16_t (*candidates)[8], bool* dead) {
+    propagateLanes<8>(candidates, dead);
+}
+
+// Every lane runs its own depth-first search. Each round propagates all lanes
+// at once, then each lane records a solution, backtracks from a
+// contradiction, or guesses the lowest candidate of its most constrained cell
+// and stacks the cell's other candidates for later. A lane whose search is
+// over takes the next puzzle, so the vector stays full until the batch runs
+// dry. Searches stop at the second solution, as countSolutions(board, 2) does.
+template <int Lanes>
+static std::size_t solveLanes(const Board* puzzles, BatchResult* results, std::size_t count,
+                              void (*propagate)(uint16_t (*)[Lanes], bool*)) {
+    typedef std::array<uint16_t, Board::CELLS> Snapshot;
+    uint16_t candidates[Board::CELLS][Lanes];
+    bool dead[Lanes];
+    std::size_t owner[Lanes];  // Puzzle searched in each lane, count when idle
+    std::vector<Snapshot> stacks[Lanes];
+    std::size_t next = 0;
+    int busy = 0;
+
+    auto load = [&](int lane) {
+        stacks[lane].clear();
+        owner[lane] = next < count ? next++ : count;
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            candidates[cell][lane] = Board::ALL_DIGITS;  // Idle lanes never progress
+        }
+        if (owner[lane] == count) return;
+
+        const Board& puzzle = puzzles[owner[lane]];
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            int row = cell / Board::SIZE, col = cell % Board::SIZE;
+            int num = puzzle.get(row, col);
+            candidates[cell][lane] = num ? Board::bit(num) : puzzle.candidates(row, col);
+        }
+        results[owner[lane]].solutionCount = 0;
+        results[owner[lane]].solution = Board();
+        busy++;
+    };
+    for (int lane = 0; lane < Lanes; lane++) {
+        load(lane);
+    }
+
+    while (busy > 0) {
+        propagate(candidates, dead);
+
+        for (int lane = 0; lane < Lanes; lane++) {
+            if (owner[lane] == count) continue;
+            BatchResult& result = results[owner[lane]];
+
+            bool backtrack = dead[lane];
+            if (!backtrack) {
+                int guessCell = -1, fewest = Board::SIZE + 1;
+                for (int cell = 0; cell < Board::CELLS && fewest > 2; cell++) {
+                    int options = Board::popcount(candidates[cell][lane]);
+                    if (options > 1 && options < fewest) {
+                        guessCell = cell;
+                        fewest = options;
+                    }
+                }
+
+                if (guessCell < 0) {
+                    // Every cell is single and no unit clashes: a solution
+                    if (result.solutionCount++ == 0) {
+                        for (int cell = 0; cell < Board::CELLS; cell++) {
+                            result.solution.place(cell / Board::SIZE, cell % Board::SIZE,
+                                                  Board::lowestDigit(candidates[cell][lane]));
+                        }
+                    }
+                    backtrack = true;
+                } else {
+                    uint16_t mask = candidates[guessCell][lane];
+                    uint16_t guess = static_cast<uint16_t>(mask & -mask);
+                    Snapshot rest;
+                    for (int cell = 0; cell < Board::CELLS; cell++) {
+                        rest[cell] = candidates[cell][lane];
+                    }
+                    rest[guessCell] = static_cast<uint16_t>(mask & ~guess);
+                    stacks[lane].push_back(rest);
+                    candidates[guessCell][lane] = guess;
+                }
+            }
+
+            if (backtrack) {
+                if (result.solutionCount >= 2 || stacks[lane].empty()) {
+                    busy--;
+                    load(lane);
+                } else {
+                    const Snapshot& rest = stacks[lane].back();
+                    for (int cell = 0; cell < Board::CELLS; cell++) {
+                        candidates[cell][lane] = rest[cell];
+                    }
+                    stacks[lane].pop_back();
+                }
+            }
+        }
+    }
+    return count;
+}
+
+#endif // SUDOKU_BATCH_SIMD
+
+SimdLevel BatchSolver::detectSimdLevel() {
+#ifdef SUDOKU_BATCH_SIMD
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+        if (__builtin_cpu_supports("sse4.2")) return SimdLevel::Sse42;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* BatchSolver::simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Sse42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+void BatchSolver::solve(const std::vector<Board>& puzzles, std::vector<BatchResult>& results) {
+    results.resize(puzzles.size());
+    solve(puzzles.data(), results.data(), puzzles.size(), detectSimdLevel());
+}
+
+void BatchSolver::solve(const Board* puzzles, BatchResult* results, std::size_t count, SimdLevel level) {
+    std::size_t done = 0;
+#ifdef SUDOKU_BATCH_SIMD
+    if (level == SimdLevel::Avx2) {
+        done = solveLanes<16>(puzzles, results, count, propagateAvx2);
+    } else if (level == SimdLevel::Sse42) {
+        done = solveLanes<8>(puzzles, results, count, propagateSse42);
+    }
+#else
+    (void)level;
+#endif
+
+    // Scalar fallback: the regular solver handles one puzzle at a time
+    for (; done < count; done++) {
+        results[done].solution = Board();
+        results[done].solutionCount = Solver::countSolutions(puzzles[done], 2, &results[done].solution);
+    }
+}
@@ -0,0 +1,31 @@
+#include "board.h"
+
+template <int Box>
+BasicBoard<Box>::BasicBoard() : cells{}, rowMask{}, colMask{}, boxMask{} {}
+
+template <int Box>
+bool BasicBoard<Box>::findEmptyCell(int& row, int& col) const {
+    for (int i = 0; i < CELLS; i++) {
+        if (cells[i] == 0) {
+            row = i / SIZE;
+            col = i % SIZE;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <int Box>
+int BasicBoard<Box>::filledCount() const {
+    int count = 0;
+    for (int i = 0; i < SIZE; i++) {
+        count += popcount(rowMask[i]);
+    }
+    return count;
+}
+
+// Supported board sizes: 4x4, 9x9, 16x16 and 25x25
+template class BasicBoard<2>;
+template class BasicBoard<3>;
+template class BasicBoard<4>;
+template class BasicBoard<5>;
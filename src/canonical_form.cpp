@@ -0,0 +1,190 @@
+#include "canonical_form.h"
+#include "random.h"
+#include <algorithm>
+#include <cstring>
+
+// The six orderings of three lines
+static const int ORDERS[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+// Search for the smallest form of one orientation (transposed or not).
+// Digits are relabeled in order of first appearance, which is the smallest
+// labeling for a given cell order. Inside a row the digits are distinct, so a
+// row's relabeled string depends only on where its empty cells are, and row 0
+// of the canonical form is the row with the fewest clues pushed furthest
+// right. That pins row 0 to a few candidate rows and the column order to the
+// few arrangements that give them that shape; the remaining rows are a
+// depth-first search pruned against the best form found so far.
+struct CanonicalForm::Search {
+    static const int SIZE = Board::SIZE;
+    static const int BOX = Board::BOX_SIZE;
+
+    uint8_t source[SIZE][SIZE];  // Puzzle, transposed or not
+    uint8_t grid[SIZE][SIZE];    // Source with the column arrangement applied
+    uint8_t firstShape[SIZE];    // Clue pattern of row 0, 1 for a clue
+    int firstRow;                // Source row that becomes row 0
+    Cells best;
+    Cells current;
+    unsigned version;            // Bumped whenever best improves
+
+    Search() : firstRow(0), version(0) { best.fill(0xFF); }
+
+    // Smallest clue pattern column moves can give a row: stacks in order of
+    // clue count, and the clues at the right end of each stack
+    static void shapeOf(const uint8_t* row, uint8_t* shape) {
+        int counts[BOX];
+        for (int stack = 0; stack < BOX; stack++) {
+            counts[stack] = 0;
+            for (int i = 0; i < BOX; i++) {
+                counts[stack] += row[stack * BOX + i] != 0;
+            }
+        }
+        std::sort(counts, counts + BOX);
+        for (int stack = 0; stack < BOX; stack++) {
+            for (int i = 0; i < BOX; i++) {
+                shape[stack * BOX + i] = i >= BOX - counts[stack];
+            }
+        }
+    }
+
+    // Picks the source stack and column order for each output stack, keeping
+    // only the choices that give firstRow the shape of row 0
+    void arrangeColumns(int stack, unsigned usedStacks) {
+        if (stack == BOX) {
+            placeFirstRow();
+            return;
+        }
+
+        for (int from = 0; from < BOX; from++) {
+            if (usedStacks & (1u << from)) continue;
+            for (const int* order : ORDERS) {
+                bool fits = true;
+                for (int i = 0; i < BOX && fits; i++) {
+                    fits = (source[firstRow][from * BOX + order[i]] != 0) == firstShape[stack * BOX + i];
+                }
+                if (!fits) continue;
+
+                for (int row = 0; row < SIZE; row++) {
+                    for (int i = 0; i < BOX; i++) {
+                        grid[row][stack * BOX + i] = source[row][from * BOX + order[i]];
+                    }
+                }
+                arrangeColumns(stack + 1, usedStacks | (1u << from));
+            }
+        }
+    }
+
+    void placeFirstRow() {
+        uint8_t labels[SIZE + 1] = {};
+        uint8_t next = 1;
+        for (int col = 0; col < SIZE; col++) {
+            uint8_t num = grid[firstRow][col];
+            if (num != 0) {
+                if (labels[num] == 0) labels[num] = next++;
+                num = labels[num];
+            }
+            current[col] = num;
+        }
+        int order = std::memcmp(current.data(), best.data(), SIZE);
+        if (order <= 0) {
+            run(1, 1u << firstRow, labels, next, firstRow / BOX, order == 0);
+        }
+    }
+
+    // Output rows 0..depth-1 are in current; prefixEqual says whether they
+    // match best. A new band starts every BOX rows, otherwise the next row
+    // has to come from the band already started.
+    void run(int depth, unsigned usedRows, const uint8_t* labels, uint8_t nextLabel, int band, bool prefixEqual) {
+        if (depth == SIZE) {
+            if (!prefixEqual) {
+                best = current;
+                version++;
+            }
+            return;
+        }
+
+        bool equal = prefixEqual;
+        int first = depth % BOX == 0 ? 0 : band * BOX;
+        int last = depth % BOX == 0 ? SIZE : first + BOX;
+        for (int row = first; row < last; row++) {
+            if (usedRows & (1u << row)) continue;
+            if (depth % BOX == 0 && (usedRows >> (row / BOX * BOX)) & ((1u << BOX) - 1)) continue;
+
+            uint8_t rowLabels[SIZE + 1];
+            std::memcpy(rowLabels, labels, sizeof(rowLabels));
+            uint8_t next = nextLabel;
+            uint8_t* out = &current[depth * SIZE];
+            for (int col = 0; col < SIZE; col++) {
+                uint8_t num = grid[row][col];
+                if (num != 0) {
+                    if (rowLabels[num] == 0) rowLabels[num] = next++;
+                    num = rowLabels[num];
+                }
+                out[col] = num;
+            }
+
+            int order = equal ? std::memcmp(out, &best[depth * SIZE], SIZE) : -1;
+            if (order > 0) continue;
+
+            unsigned before = version;
+            run(depth + 1, usedRows | (1u << row), rowLabels, next, row / BOX, equal && order == 0);
+            // An improvement found below extends the current prefix
+            if (version != before) equal = true;
+        }
+    }
+};
+
+CanonicalForm::Cells CanonicalForm::minlex(const Board& puzzle) {
+    const int SIZE = Board::SIZE;
+
+    Search search;
+    std::fill(search.firstShape, search.firstShape + SIZE, 1);
+    uint8_t oriented[2][SIZE][SIZE];
+    for (int transpose = 0; transpose < 2; transpose++) {
+        for (int row = 0; row < SIZE; row++) {
+            for (int col = 0; col < SIZE; col++) {
+                oriented[transpose][row][col] = static_cast<uint8_t>(transpose ? puzzle.get(col, row) : puzzle.get(row, col));
+            }
+            uint8_t shape[SIZE];
+            Search::shapeOf(oriented[transpose][row], shape);
+            if (std::lexicographical_compare(shape, shape + SIZE, search.firstShape, search.firstShape + SIZE)) {
+                std::copy(shape, shape + SIZE, search.firstShape);
+            }
+        }
+    }
+
+    for (int transpose = 0; transpose < 2; transpose++) {
+        std::memcpy(search.source, oriented[transpose], sizeof(search.source));
+        for (int row = 0; row < SIZE; row++) {
+            uint8_t shape[SIZE];
+            Search::shapeOf(search.source[row], shape);
+            if (std::equal(shape, shape + SIZE, search.firstShape)) {
+                search.firstRow = row;
+                search.arrangeColumns(0, 0);
+            }
+        }
+    }
+    return search.best;
+}
+
+PuzzleHash CanonicalForm::hash(const Board& puzzle) {
+    Cells cells = minlex(puzzle);
+
+    // Two independently seeded splitmix64 chains over the cells packed 16 to
+    // a word, four bits each
+    uint64_t high = 0x243F6A8885A308D3ull;
+    uint64_t low = 0x13198A2E03707344ull;
+    for (int start = 0; start < Board::CELLS; start += 16) {
+        uint64_t word = 0;
+        for (int i = start; i < start + 16 && i < Board::CELLS; i++) {
+            word = (word << 4) | cells[i];
+        }
+        uint64_t highState = high ^ word;
+        uint64_t lowState = low + word;
+        high = Random::splitmix64(highState);
+        low = Random::splitmix64(lowState);
+    }
+
+    PuzzleHash result{high, low};
+    if (result.high == 0 && result.low == 0) result.low = 1;  // All zero marks an empty index slot
+    return result;
+}
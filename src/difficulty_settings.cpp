@@ -1,3 +1,4 @@
 #include "difficulty_settings.h"
 
-Slide DifficultySettings::difficultySlider;
\ No newline at end of file
+Slide DifficultySettings::difficultySlider;
+int DifficultySettings::boxSize = 3;
\ No newline at end of file
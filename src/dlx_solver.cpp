@@ -0,0 +1,165 @@
+#include "dlx_solver.h"
+#include "generation_stats.h"
+
+// Column layout: [cell | row-digit | column-digit | box-digit], CELLS each
+template <int Box> static int cellColumn(int row, int col) { return row * Box * Box + col; }
+template <int Box> static int rowColumn(int row, int num) { return BasicBoard<Box>::CELLS + row * Box * Box + num - 1; }
+template <int Box> static int colColumn(int col, int num) { return 2 * BasicBoard<Box>::CELLS + col * Box * Box + num - 1; }
+template <int Box> static int boxColumn(int box, int num) { return 3 * BasicBoard<Box>::CELLS + box * Box * Box + num - 1; }
+
+template <int Box>
+BasicDlxSolver<Box>::BasicDlxSolver(const Board& board)
+    : columnSize(COLUMNS, 0), givens(board), limit(0), count(0), firstSolution(nullptr) {
+    nodes.reserve(COLUMNS + 1 + 4 * ROWS);
+
+    // Columns already covered by a given never enter the header ring
+    std::vector<bool> satisfied(COLUMNS, false);
+    for (int row = 0; row < Board::SIZE; row++) {
+        for (int col = 0; col < Board::SIZE; col++) {
+            int num = board.get(row, col);
+            if (num == 0) continue;
+            satisfied[cellColumn<Box>(row, col)] = true;
+            satisfied[rowColumn<Box>(row, num)] = true;
+            satisfied[colColumn<Box>(col, num)] = true;
+            satisfied[boxColumn<Box>(Board::boxIndex(row, col), num)] = true;
+        }
+    }
+
+    for (int i = 0; i <= COLUMNS; i++) {
+        nodes.push_back(Node{i, i, i, i, i, -1});
+    }
+    for (int column = 0; column < COLUMNS; column++) {
+        if (satisfied[column]) continue;
+        nodes[column].left = nodes[ROOT].left;
+        nodes[column].right = ROOT;
+        nodes[nodes[ROOT].left].right = column;
+        nodes[ROOT].left = column;
+    }
+
+    // Only candidates consistent with the givens become rows
+    for (int row = 0; row < Board::SIZE; row++) {
+        for (int col = 0; col < Board::SIZE; col++) {
+            if (!board.isEmpty(row, col)) continue;
+            for (typename Board::Mask candidates = board.candidates(row, col); candidates; candidates &= candidates - 1) {
+                addRow(row, col, Board::lowestDigit(candidates));
+            }
+        }
+    }
+}
+
+template <int Box>
+void BasicDlxSolver<Box>::addRow(int row, int col, int num) {
+    const int columns[4] = {
+        cellColumn<Box>(row, col),
+        rowColumn<Box>(row, num),
+        colColumn<Box>(col, num),
+        boxColumn<Box>(Board::boxIndex(row, col), num)
+    };
+    int first = static_cast<int>(nodes.size());
+    int rowId = cellColumn<Box>(row, col) * Board::SIZE + num - 1;
+
+    for (int k = 0; k < 4; k++) {
+        int column = columns[k];
+        int id = first + k;
+        Node node;
+        node.left = k == 0 ? first + 3 : id - 1;
+        node.right = k == 3 ? first : id + 1;
+        node.up = nodes[column].up;
+        node.down = column;
+        node.column = column;
+        node.row = rowId;
+        nodes.push_back(node);
+        nodes[nodes[column].up].down = id;
+        nodes[column].up = id;
+        columnSize[column]++;
+    }
+}
+
+template <int Box>
+void BasicDlxSolver<Box>::cover(int column) {
+    nodes[nodes[column].right].left = nodes[column].left;
+    nodes[nodes[column].left].right = nodes[column].right;
+    for (int i = nodes[column].down; i != column; i = nodes[i].down) {
+        for (int j = nodes[i].right; j != i; j = nodes[j].right) {
+            nodes[nodes[j].down].up = nodes[j].up;
+            nodes[nodes[j].up].down = nodes[j].down;
+            columnSize[nodes[j].column]--;
+        }
+    }
+}
+
+template <int Box>
+void BasicDlxSolver<Box>::uncover(int column) {
+    for (int i = nodes[column].up; i != column; i = nodes[i].up) {
+        for (int j = nodes[i].left; j != i; j = nodes[j].left) {
+            columnSize[nodes[j].column]++;
+            nodes[nodes[j].down].up = j;
+            nodes[nodes[j].up].down = j;
+        }
+    }
+    nodes[nodes[column].right].left = column;
+    nodes[nodes[column].left].right = column;
+}
+
+template <int Box>
+int BasicDlxSolver<Box>::countSolutions(int maxSolutions, Board* solution) {
+    limit = maxSolutions;
+    count = 0;
+    firstSolution = solution;
+    partial.clear();
+    if (limit > 0) {
+        search();
+    }
+    return count;
+}
+
+template <int Box>
+void BasicDlxSolver<Box>::search() {
+    SUDOKU_STAT_ADD(nodeVisits, 1);
+    if (nodes[ROOT].right == ROOT) {
+        recordSolution();
+        return;
+    }
+
+    // Branch on the constraint with the fewest remaining candidates
+    int best = nodes[ROOT].right;
+    for (int column = nodes[best].right; column != ROOT && columnSize[best] > 1; column = nodes[column].right) {
+        if (columnSize[column] < columnSize[best]) {
+            best = column;
+        }
+    }
+    if (columnSize[best] == 0) {
+        SUDOKU_STAT_ADD(backtracks, 1);
+        return;
+    }
+
+    cover(best);
+    for (int i = nodes[best].down; i != best && count < limit; i = nodes[i].down) {
+        partial.push_back(nodes[i].row);
+        for (int j = nodes[i].right; j != i; j = nodes[j].right) {
+            cover(nodes[j].column);
+        }
+        search();
+        for (int j = nodes[i].left; j != i; j = nodes[j].left) {
+            uncover(nodes[j].column);
+        }
+        partial.pop_back();
+    }
+    uncover(best);
+}
+
+template <int Box>
+void BasicDlxSolver<Box>::recordSolution() {
+    if (count++ == 0 && firstSolution) {
+        *firstSolution = givens;
+        for (int rowId : partial) {
+            int cell = rowId / Board::SIZE;
+            firstSolution->place(cell / Board::SIZE, cell % Board::SIZE, rowId % Board::SIZE + 1);
+        }
+    }
+}
+
+template class BasicDlxSolver<2>;
+template class BasicDlxSolver<3>;
+template class BasicDlxSolver<4>;
+template class BasicDlxSolver<5>;
@@ -0,0 +1,142 @@
+#include "font_manager.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// System fonts by preference, lower case; the first is the look the game was
+// designed with, the others ship with most Linux distributions
+static const char* const PREFERRED_FONTS[] = {"arial.ttf", "dejavusans.ttf", "liberationsans-regular.ttf"};
+static const int PREFERRED_COUNT = sizeof(PREFERRED_FONTS) / sizeof(PREFERRED_FONTS[0]);
+
+FontManager::FontManager() {}
+
+FontManager::~FontManager() {
+    close();
+}
+
+static std::string lowerFileName(const fs::path& file) {
+    std::string name = file.filename().string();
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return name;
+}
+
+static std::string envPath(const char* name, const char* suffix) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::string(value) + suffix : std::string();
+}
+
+// Adds the preferred fonts among the files of dir to found, one list per
+// preferred font; recursive for the fontconfig trees
+static void collectFonts(const std::string& dir, bool recursive, std::vector<std::string> (&found)[PREFERRED_COUNT]) {
+    std::error_code error;
+    if (dir.empty() || !fs::is_directory(dir, error)) return;
+
+    auto consider = [&](const fs::directory_entry& entry) {
+        std::string name = lowerFileName(entry.path());
+        for (int i = 0; i < PREFERRED_COUNT; i++) {
+            if (name == PREFERRED_FONTS[i]) {
+                found[i].push_back(entry.path().string());
+            }
+        }
+    };
+    if (recursive) {
+        fs::recursive_directory_iterator it(dir, fs::directory_options::skip_permission_denied, error), end;
+        for (; !error && it != end; it.increment(error)) {
+            consider(*it);
+        }
+    } else {
+        fs::directory_iterator it(dir, error), end;
+        for (; !error && it != end; it.increment(error)) {
+            consider(*it);
+        }
+    }
+}
+
+std::vector<std::string> FontManager::candidates() {
+    std::vector<std::string> files;
+    std::string configured = envPath("SUDOKU_FONT", "");
+    if (!configured.empty()) {
+        files.push_back(configured);
+    }
+
+    // Any font dropped into the bundled folder, in name order
+    std::vector<std::string> bundled;
+    std::error_code error;
+    fs::directory_iterator it("assets/fonts", error), end;
+    for (; !error && it != end; it.increment(error)) {
+        std::string name = lowerFileName(it->path());
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".ttf") == 0) {
+            bundled.push_back(it->path().string());
+        }
+    }
+    std::sort(bundled.begin(), bundled.end());
+    files.insert(files.end(), bundled.begin(), bundled.end());
+
+    std::vector<std::string> found[PREFERRED_COUNT];
+    std::string windows = envPath("WINDIR", "\\Fonts");
+    collectFonts(windows.empty() ? "C:\\Windows\\Fonts" : windows, false, found);
+    collectFonts("/Library/Fonts", false, found);
+    collectFonts("/System/Library/Fonts/Supplemental", false, found);
+    collectFonts(envPath("HOME", "/Library/Fonts"), false, found);
+    std::string xdgData = envPath("XDG_DATA_HOME", "/fonts");
+    collectFonts(xdgData.empty() ? envPath("HOME", "/.local/share/fonts") : xdgData, true, found);
+    collectFonts(envPath("HOME", "/.fonts"), true, found);
+    collectFonts("/usr/local/share/fonts", true, found);
+    collectFonts("/usr/share/fonts", true, found);
+    for (const std::vector<std::string>& paths : found) {
+        files.insert(files.end(), paths.begin(), paths.end());
+    }
+    return files;
+}
+
+bool FontManager::open(const std::vector<int>& sizes) {
+    close();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> files = candidates();
+    for (const std::string& file : files) {
+        if (openAll(file, sizes)) {
+            path = file;
+            break;
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (path.empty()) {
+        std::cerr << "No usable font among " << files.size()
+                  << " candidates; set SUDOKU_FONT to a .ttf file" << std::endl;
+        return false;
+    }
+    std::cerr << "Font " << path << ": " << sizes.size() << " sizes opened in " << ms << " ms" << std::endl;
+    return true;
+}
+
+bool FontManager::openAll(const std::string& file, const std::vector<int>& sizes) {
+    for (int size : sizes) {
+        if (fonts.count(size)) continue;
+        TTF_Font* font = TTF_OpenFont(file.c_str(), size);
+        if (!font) {
+            close();
+            return false;
+        }
+        fonts[size] = font;
+    }
+    return true;
+}
+
+void FontManager::close() {
+    for (auto& entry : fonts) {
+        TTF_CloseFont(entry.second);
+    }
+    fonts.clear();
+    path.clear();
+}
+
+TTF_Font* FontManager::get(int size) const {
+    auto found = fonts.find(size);
+    return found == fonts.end() ? nullptr : found->second;
+}
@@ -1,10 +1,46 @@
 #include "game.h"
 #include "renderer.h"
 #include <SDL2/SDL.h>
+#include "byte_order.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <type_traits>
 
 int Game::currentElapsedSeconds = 0;  // Initialize static member
 
-Game::Game() : running(false), state(GameState::MENU), selectedRow(-1), selectedCol(-1), startTime(0), elapsedSeconds(0) {
+// Save file: "SDKS", u16 version, u8 box size, u8 reserved, u32 elapsed
+// seconds (little-endian), then the game as BasicSudoku::writeState lays it out
+static const char SAVE_MAGIC[4] = {'S', 'D', 'K', 'S'};
+static const uint16_t SAVE_VERSION = 1;
+static const std::size_t SAVE_HEADER_SIZE = 12;
+
+template <int Box>
+static std::vector<unsigned char> encodeSave(const BasicSudoku<Box>& board, int elapsedSeconds) {
+    std::vector<unsigned char> bytes(SAVE_HEADER_SIZE + BasicSudoku<Box>::STATE_SIZE);
+    std::memcpy(bytes.data(), SAVE_MAGIC, 4);
+    writeLE(&bytes[4], SAVE_VERSION, 2);
+    writeLE(&bytes[6], Box, 1);
+    writeLE(&bytes[7], 0, 1);
+    writeLE(&bytes[8], static_cast<uint32_t>(elapsedSeconds), 4);
+    board.writeState(&bytes[SAVE_HEADER_SIZE]);
+    return bytes;
+}
+
+template <int Box>
+static bool decodeSave(const std::vector<unsigned char>& bytes, AnySudoku& sudoku) {
+    if (bytes.size() != SAVE_HEADER_SIZE + BasicSudoku<Box>::STATE_SIZE) return false;
+    BasicSudoku<Box> board;
+    if (!board.readState(&bytes[SAVE_HEADER_SIZE])) return false;
+    sudoku = board;
+    return true;
+}
+
+Game::Game() : pendingDifficulty(0.5f), running(false), dirty(true), state(GameState::MENU), selectedRow(-1), selectedCol(-1), startTime(0), elapsedSeconds(0),
+               logFrames(false), frameCount(0), frameWindowCount(0), frameWindowStart(0) {
 }
 
 Game::~Game() {}
@@ -13,100 +49,301 @@ bool Game::init() {
     if (!renderer.init()) {
         return false;
     }
+    journal.setListener(&hints);
+    // The puzzle bank is optional; without it every puzzle is generated live.
+    // The first puzzles are prepared in the background while the menu is up.
+    const char* bankPath = std::getenv("SUDOKU_BANK");
+    puzzleBank.open(bankPath ? bankPath : "puzzles.bank");
+    prefetcher.start(&puzzleBank);
+
+    // A game left running is resumed where it stopped. SUDOKU_SAVE moves the
+    // save file away from the working directory.
+    const char* savePath = std::getenv("SUDOKU_SAVE");
+    std::string path = savePath ? savePath : "sudoku.save";
+    std::vector<unsigned char> saved;
+    bool resumed = Autosaver::load(path, saved) && restoreSave(saved);
+    autosaver.start(path);
+    // SUDOKU_JOURNAL captures each session's moves for replay (see sudoku-bench --replay)
+    if (const char* path = std::getenv("SUDOKU_JOURNAL")) {
+        journalPath = path;
+    }
+
+    // SUDOKU_FRAMES=1 logs how many frames are drawn, idle ones included
+    if (const char* frames = std::getenv("SUDOKU_FRAMES")) {
+        logFrames = std::string(frames) == "1";
+    }
+
     running = true;
-    startTime = SDL_GetTicks();
+    dirty = true;
+    startTime = SDL_GetTicks() - static_cast<Uint32>(elapsedSeconds) * 1000;
+    frameWindowStart = SDL_GetTicks();
+    if (resumed) {
+        state = GameState::PLAYING;
+        std::visit([&](const auto& board) {
+            journal.start(board, SDL_GetTicks());
+            hints.reset(board);
+        }, sudoku);
+    }
     return true;
 }
 
+// Starts a puzzle of the chosen size for the slider's difficulty without
+// waiting on the frame thread. 9x9 puzzles come from the prefetcher, which
+// usually has one ready; the other sizes take seconds to generate, so they
+// are made on a one-shot worker. Until the puzzle is there the window shows
+// a waiting screen and keeps handling events.
+void Game::startNewPuzzle() {
+    saveJournal();
+    float difficulty = DifficultySettings::getDifficultySlider()->value;
+    int box = DifficultySettings::getBoxSize();
+    pendingPuzzle = std::future<AnySudoku>();
+    pendingDifficulty = difficulty;
+    if (box != Sudoku::SUBGRID_SIZE) {
+        // The worker owns its task and only shares the future's state, so it can
+        // be left behind if the game quits before the puzzle is done. Generation
+        // touches no static that has a destructor, so process exit does not race it.
+        std::packaged_task<AnySudoku()> task([box, difficulty]() -> AnySudoku {
+            switch (box) {
+                case 2: return BasicSudoku<2>(difficulty);
+                case 4: return BasicSudoku<4>(difficulty);
+                default: return BasicSudoku<5>(difficulty);
+            }
+        });
+        pendingPuzzle = task.get_future();
+        std::thread(std::move(task)).detach();
+    }
+    state = GameState::GENERATING;
+    selectedRow = selectedCol = -1;
+    dirty = true;
+    pollPendingPuzzle();  // A prefetched 9x9 puzzle starts right away
+}
+
+// Swaps in the puzzle once the prefetcher or the worker has it
+void Game::pollPendingPuzzle() {
+    if (pendingPuzzle.valid()) {
+        if (pendingPuzzle.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            beginPuzzle(pendingPuzzle.get());
+        }
+        return;
+    }
+    Sudoku puzzle;
+    if (prefetcher.tryTake(pendingDifficulty, puzzle)) {
+        beginPuzzle(std::move(puzzle));
+    }
+}
+
+// Leaves the current game for the menu; Start Game hands over a fresh
+// puzzle for the slider setting
+void Game::returnToMenu() {
+    saveJournal();
+    journal = MoveJournal();
+    journal.setListener(&hints);
+    state = GameState::MENU;
+    sudoku = Sudoku();
+    selectedRow = selectedCol = -1;
+    elapsedSeconds = 0;
+    currentElapsedSeconds = 0;
+    dirty = true;
+}
+
+// Makes board the game being played and resets the session around it
+void Game::beginPuzzle(AnySudoku board) {
+    sudoku = std::move(board);
+    state = GameState::PLAYING;
+    std::visit([&](const auto& board) {
+        journal.start(board, SDL_GetTicks());
+        hints.reset(board);
+    }, sudoku);
+    selectedRow = selectedCol = -1;
+    startTime = SDL_GetTicks();
+    elapsedSeconds = 0;
+    currentElapsedSeconds = 0;
+    dirty = true;
+    autosave();
+}
+
+// Hands the game, a few hundred bytes, to the autosaver thread; the disk
+// write never holds up a frame
+void Game::autosave() {
+    if (state != GameState::PLAYING) return;
+    int elapsed = static_cast<int>((SDL_GetTicks() - startTime) / 1000);
+    autosaver.save(std::visit([&](const auto& board) { return encodeSave(board, elapsed); }, sudoku));
+}
+
+bool Game::restoreSave(const std::vector<unsigned char>& bytes) {
+    if (bytes.size() < SAVE_HEADER_SIZE || std::memcmp(bytes.data(), SAVE_MAGIC, 4) != 0 ||
+        readLE(&bytes[4], 2) != SAVE_VERSION) {
+        return false;
+    }
+    bool restored = false;
+    switch (bytes[6]) {
+        case 2: restored = decodeSave<2>(bytes, sudoku); break;
+        case 3: restored = decodeSave<3>(bytes, sudoku); break;
+        case 4: restored = decodeSave<4>(bytes, sudoku); break;
+        case 5: restored = decodeSave<5>(bytes, sudoku); break;
+    }
+    if (restored) {
+        elapsedSeconds = static_cast<int>(readLE(&bytes[8], 4));
+        currentElapsedSeconds = elapsedSeconds;
+        DifficultySettings::setBoxSize(bytes[6]);
+    }
+    return restored;
+}
+
+void Game::saveJournal() {
+    if (!journalPath.empty() && journal.size() > 0 && !journal.save(journalPath)) {
+        std::cerr << "Cannot write " << journalPath << std::endl;
+    }
+}
+
+int Game::gridSize() const {
+    return std::visit([](const auto& board) { return board.GRID_SIZE; }, sudoku);
+}
+
+// Frames are drawn only when something on screen may have changed: after an
+// event, or when the timer reaches its next second. In between the loop
+// sleeps in SDL_WaitEventTimeout, so an idle game draws about one frame a
+// second while playing and none in the menu.
 void Game::run() {
     while (running) {
-        // First: Handle all input events
+        // First: Sleep until an event arrives or the timer needs a frame
+        if (!dirty) {
+            SDL_Event event;
+            int timeout = state == GameState::PLAYING ? msToNextSecond()
+                        : state == GameState::GENERATING ? GENERATION_POLL_MS : -1;
+            bool woken = timeout < 0 ? SDL_WaitEvent(&event) != 0 : SDL_WaitEventTimeout(&event, timeout) != 0;
+            if (woken) {
+                handleEvent(event);
+            }
+        }
+
+        // Second: Handle the rest of the input events
         handleEvents();
         
-        // Second: Update game state
-        if (state == GameState::PLAYING) {
+        // Third: Update game state
+        if (running && state == GameState::PLAYING) {
             updateTimer();
+        } else if (running && state == GameState::GENERATING) {
+            pollPendingPuzzle();
         }
         
-        // Third: Render the current state
-        if (running) {  // Only render if we're still running
+        // Fourth: Render the current state
+        if (running && dirty) {
             if (state == GameState::MENU) {
                 renderer.renderMenuScreen();
             } else if (state == GameState::PLAYING) {
-                renderer.render(sudoku, selectedRow, selectedCol);
+                std::visit([&](const auto& board) { renderer.render(board, selectedRow, selectedCol, hints.visibleHint<std::decay_t<decltype(board)>::SUBGRID_SIZE>()); }, sudoku);
+            } else if (state == GameState::GENERATING) {
+                int size = DifficultySettings::getBoxSize() * DifficultySettings::getBoxSize();
+                renderer.renderWaitScreen("Generating " + std::to_string(size) + "x" + std::to_string(size) + " puzzle...");
             }
-            SDL_Delay(16); // Cap at ~60 FPS
+            dirty = false;
+            countFrame();
         }
     }
+    if (logFrames) {
+        std::cerr << "Frames: " << frameCount << " in total" << std::endl;
+    }
+}
+
+int Game::msToNextSecond() const {
+    Uint32 nextSecond = startTime + static_cast<Uint32>(elapsedSeconds + 1) * 1000;
+    return std::max(0, static_cast<int>(nextSecond - SDL_GetTicks()));
 }
 
 void Game::updateTimer() {
     if (running) {
         Uint32 currentTime = SDL_GetTicks();
-        elapsedSeconds = (currentTime - startTime) / 1000;
+        int seconds = static_cast<int>((currentTime - startTime) / 1000);
+        if (seconds != elapsedSeconds) {
+            dirty = true;  // The clock shows a new second
+        }
+        elapsedSeconds = seconds;
         currentElapsedSeconds = elapsedSeconds;  // Update static member
-        renderer.renderTimer(elapsedSeconds);
+    }
+}
+
+// With SUDOKU_FRAMES=1, logs how many frames the last stretch of at least
+// ten seconds drew
+void Game::countFrame() {
+    frameCount++;
+    if (!logFrames) return;
+    Uint32 now = SDL_GetTicks();
+    Uint32 window = now - frameWindowStart;
+    if (window >= 10000) {
+        std::cerr << "Frames: " << frameCount - frameWindowCount << " in " << window / 1000.0 << " s ("
+                  << (frameCount - frameWindowCount) * 1000.0 / window << " per second)" << std::endl;
+        frameWindowStart = now;
+        frameWindowCount = frameCount;
     }
 }
 
 void Game::handleEvents() {
     SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_QUIT:
-                SDL_Quit();
-                exit(0);
-                break;
-            case SDL_MOUSEBUTTONDOWN:
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    if (state == GameState::MENU) {
-                        // Check if click is on slider handle
-                        int handleX = DifficultySettings::getDifficultySlider()->slider.x + (int)(DifficultySettings::getDifficultySlider()->value * DifficultySettings::getDifficultySlider()->slider.w);
-                        SDL_Rect handle = {handleX - 10, DifficultySettings::getDifficultySlider()->slider.y - 5, 20, 30};
-                        if (event.button.x >= handle.x && event.button.x <= handle.x + handle.w &&
-                            event.button.y >= handle.y && event.button.y <= handle.y + handle.h) {
-                            DifficultySettings::getDifficultySlider()->isDragging = true;
-                        } else {
-                            handleMouseClick(event.button.x, event.button.y);
-                        }
+    while (running && SDL_PollEvent(&event)) {
+        handleEvent(event);
+    }
+}
+
+void Game::handleEvent(const SDL_Event& event) {
+    // Input, window exposure and the like may all change what is on screen
+    dirty = true;
+    switch (event.type) {
+        case SDL_QUIT:
+            // Leave through run() so the autosaver finishes its last write
+            autosave();
+            saveJournal();
+            running = false;
+            return;
+        case SDL_MOUSEBUTTONDOWN:
+            if (event.button.button == SDL_BUTTON_LEFT) {
+                if (state == GameState::MENU) {
+                    // Check if click is on slider handle
+                    int handleX = DifficultySettings::getDifficultySlider()->slider.x + (int)(DifficultySettings::getDifficultySlider()->value * DifficultySettings::getDifficultySlider()->slider.w);
+                    SDL_Rect handle = {handleX - 10, DifficultySettings::getDifficultySlider()->slider.y - 5, 20, 30};
+                    if (event.button.x >= handle.x && event.button.x <= handle.x + handle.w &&
+                        event.button.y >= handle.y && event.button.y <= handle.y + handle.h) {
+                        DifficultySettings::getDifficultySlider()->isDragging = true;
                     } else {
                         handleMouseClick(event.button.x, event.button.y);
                     }
+                } else {
+                    handleMouseClick(event.button.x, event.button.y);
                 }
-                break;
-            case SDL_MOUSEBUTTONUP:
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    DifficultySettings::getDifficultySlider()->isDragging = false;
-                }
-                break;
-            case SDL_MOUSEMOTION:
-                if (state == GameState::MENU && DifficultySettings::getDifficultySlider()->isDragging) {
-                    renderer.updateDifficultySlider(event.motion.x);
+            }
+            break;
+        case SDL_MOUSEBUTTONUP:
+            if (event.button.button == SDL_BUTTON_LEFT) {
+                if (DifficultySettings::getDifficultySlider()->isDragging) {
+                    prefetcher.setDifficulty(DifficultySettings::getDifficultySlider()->value);
                 }
-                break;
-            case SDL_KEYDOWN:
-                handleKeyPress(event.key.keysym.sym);
-                break;
-        }
+                DifficultySettings::getDifficultySlider()->isDragging = false;
+            }
+            break;
+        case SDL_MOUSEMOTION:
+            if (state == GameState::MENU && DifficultySettings::getDifficultySlider()->isDragging) {
+                renderer.updateDifficultySlider(event.motion.x);
+            }
+            break;
+        case SDL_KEYDOWN:
+            handleKeyPress(event.key.keysym.sym);
+            break;
     }
 }
 
 bool Game::handleMenuClick(int x, int y) {
     if (renderer.handleMenuClick(x, y)) {
-        state = GameState::PLAYING;
-        startTime = SDL_GetTicks();
+        startNewPuzzle();
         return true;
     }
     return false;
 }
 
 void Game::handleMouseClick(int x, int y) {
+    if (state == GameState::GENERATING) return;  // Nothing to click until the puzzle is ready
     if (state == GameState::PLAYING && renderer.handleResetButtonClick(x, y)) {
         // Reset the game with current settings
-        sudoku = Sudoku();
-        startTime = SDL_GetTicks();
-        selectedRow = -1;
-        selectedCol = -1;
+        startNewPuzzle();
         return;
     }
     if (state == GameState::MENU) {
@@ -114,7 +351,7 @@ void Game::handleMouseClick(int x, int y) {
         return;
     }
     int newRow, newCol;
-    renderer.getGridPosition(x, y, newRow, newCol);
+    renderer.getGridPosition(x, y, gridSize(), newRow, newCol);
     
     // If clicking the same cell that's already selected, unselect it
     if (newRow == selectedRow && newCol == selectedCol) {
@@ -123,39 +360,82 @@ void Game::handleMouseClick(int x, int y) {
     }
     
     // Otherwise, try to select the new cell if it's editable
-    if (sudoku.isCellEditable(newRow, newCol)) {
+    if (std::visit([&](const auto& board) { return board.isCellEditable(newRow, newCol); }, sudoku)) {
         selectedRow = newRow;
         selectedCol = newCol;
         // When selecting a cell, turn off number highlighting
-        sudoku.setHighlightedNumber(0);
+        std::visit([](auto& board) { board.setHighlightedNumber(0); }, sudoku);
     } else {
         selectedRow = selectedCol = -1;
     }
 }
 
 void Game::handleKeyPress(SDL_Keycode key) {
+    if (state == GameState::GENERATING) {
+        // A big board can take a while; Esc gives up on it. The worker cannot
+        // be interrupted, so it finishes on its own and its puzzle is dropped.
+        if (key == SDLK_ESCAPE) {
+            pendingPuzzle = std::future<AnySudoku>();
+            returnToMenu();
+        }
+        return;
+    }
+
+    // H asks for a hint; on 25x25, where H is a symbol, hold Ctrl
+    bool ctrl = (SDL_GetModState() & KMOD_CTRL) != 0;
+    if (state == GameState::PLAYING && key == SDLK_h && (ctrl || SDLK_h - SDLK_a + 10 > gridSize())) {
+        std::visit([&](const auto& board) { hints.showHint(board); }, sudoku);
+        return;
+    }
+
+    // Ctrl+Z undoes the last move, Ctrl+Y or Ctrl+Shift+Z redoes it
+    if (state == GameState::PLAYING && ctrl && (key == SDLK_z || key == SDLK_y)) {
+        bool redo = key == SDLK_y || (SDL_GetModState() & KMOD_SHIFT) != 0;
+        if (std::visit([&](auto& board) { return redo ? journal.redo(board) : journal.undo(board); }, sudoku)) {
+            autosave();
+            if (redo) checkWinCondition();
+        }
+        return;
+    }
+
+    // Digits 1-9, then letters for 10 and up on the larger boards
+    int number = 0;
     if (key >= SDLK_1 && key <= SDLK_9) {
-        int number = key - SDLK_0;
+        number = key - SDLK_0;
+    } else if (key >= SDLK_a && key <= SDLK_z) {
+        number = key - SDLK_a + 10;
+    }
+
+    if (number > 0 && number <= gridSize()) {
         if (selectedRow == -1 || selectedCol == -1) {
-            sudoku.setHighlightedNumber(number);
+            std::visit([&](auto& board) { board.setHighlightedNumber(number); }, sudoku);
             return;
         }
-        if (sudoku.setNumber(selectedRow, selectedCol, number)) {
+        if (std::visit([&](auto& board) { return journal.play(board, selectedRow, selectedCol, number, SDL_GetTicks()); }, sudoku)) {
+            autosave();
             checkWinCondition();
         }
-    } else if (key == SDLK_BACKSPACE || key == SDLK_DELETE) {
-        sudoku.setNumber(selectedRow, selectedCol, 0);
+    } else if ((key == SDLK_BACKSPACE || key == SDLK_DELETE) && selectedRow != -1 && selectedCol != -1) {
+        if (std::visit([&](auto& board) { return journal.play(board, selectedRow, selectedCol, 0, SDL_GetTicks()); }, sudoku)) {
+            autosave();
+        }
     }
 }
 
 void Game::checkWinCondition() {
-    if (sudoku.isSolved()) {
+    if (std::visit([](const auto& board) { return board.isSolved(); }, sudoku)) {
+        autosaver.discard();  // A finished game has nothing to resume
         bool shouldClose = false;
         SDL_Event event;
         int clickResult = 0;
         
+        // Nothing on the victory screen moves on its own: draw it, then redraw
+        // only after events, for the button hover and click effects
         while (clickResult == 0 && !shouldClose) {
-            while (SDL_PollEvent(&event)) {
+            renderer.renderVictoryScreen(std::visit([](const auto& board) { return board.getScore(); }, sudoku), elapsedSeconds);
+            countFrame();
+            if (!SDL_WaitEvent(&event)) break;
+            do {
                 switch (event.type) {
                     case SDL_QUIT:
                         shouldClose = true;
@@ -167,28 +447,17 @@ void Game::checkWinCondition() {
                         }
                         break;
                 }
-            }
-            
-            if (!shouldClose) {
-                renderer.renderVictoryScreen(sudoku.getScore(), elapsedSeconds);
-                SDL_Delay(16);
-            }
+            } while (SDL_PollEvent(&event));
         }
+        dirty = true;
         
         if (clickResult == 1) {  // New Game
-            sudoku = Sudoku();
-            selectedRow = selectedCol = -1;
-            startTime = SDL_GetTicks();
-            elapsedSeconds = 0;
-            currentElapsedSeconds = 0;
+            startNewPuzzle();
         } else if (clickResult == 2) {  // Main Menu
-            state = GameState::MENU;
-            sudoku = Sudoku();
-            selectedRow = selectedCol = -1;
-            startTime = SDL_GetTicks();
-            elapsedSeconds = 0;
-            currentElapsedSeconds = 0;
-        } else if(shouldClose) {
+            returnToMenu();
+        } else if (shouldClose || clickResult == 3) {  // Window closed or Exit
+            // run() returns and the autosaver finishes the discard above
+            saveJournal();
             running = false;
         }
     }
@@ -0,0 +1,32 @@
+#include "generation_stats.h"
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+bool GenerationStats::logging = false;
+
+void GenerationStats::merge(const GenerationStats& other) {
+    nodeVisits += other.nodeVisits;
+    backtracks += other.backtracks;
+    solutionCounts += other.solutionCounts;
+    ratings += other.ratings;
+    rejectedRemovals += other.rejectedRemovals;
+    attempts += other.attempts;
+    clues += other.clues;
+    fillSeconds += other.fillSeconds;
+    digSeconds += other.digSeconds;
+    totalSeconds += other.totalSeconds;
+}
+
+void GenerationStats::log(std::ostream& out, const std::string& label) const {
+    // Built whole and written at once so lines from generator threads stay intact
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1) << label << ": "
+         << clues << " clues, rating " << rating << " (target " << minRating << "-" << maxRating << "), "
+         << attempts << " attempts, " << nodeVisits << " nodes, " << backtracks << " backtracks, "
+         << solutionCounts << " solution counts, " << ratings << " ratings, "
+         << rejectedRemovals << " rejected removals, " << std::setprecision(3)
+         << "fill " << fillSeconds * 1e3 << " ms, dig " << digSeconds * 1e3 << " ms, total "
+         << totalSeconds * 1e3 << " ms\n";
+    out << line.str();
+}
@@ -0,0 +1,164 @@
+#include "grid_synthesizer.h"
+#include "generation_stats.h"
+#include <numeric>
+
+GridSource GridSynthesizer::source = GridSource::Backtracking;
+
+bool GridSynthesizer::parseSource(const std::string& name, GridSource& result) {
+    if (name == "backtracking") {
+        result = GridSource::Backtracking;
+    } else if (name == "transform") {
+        result = GridSource::Transform;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* GridSynthesizer::sourceName(GridSource source) {
+    return source == GridSource::Transform ? "transform" : "backtracking";
+}
+
+template <int Box>
+void GridSynthesizer::fill(BasicBoard<Box>& board, Random& rng) {
+    if (source == GridSource::Transform) {
+        transformedGrid(board, rng);
+    } else {
+        backtrackingGrid(board, rng);
+    }
+}
+
+template <int Box>
+void GridSynthesizer::backtrackingGrid(BasicBoard<Box>& board, Random& rng) {
+    const int SIZE = BasicBoard<Box>::SIZE;
+
+    // The diagonal boxes share no unit, so they can be filled independently.
+    // On 4x4 that can leave no way to finish the grid, and on the larger
+    // boards some fillings send the search into a dead subtree it needs
+    // minutes to leave, so start over on either with a node budget.
+    long budget;
+    do {
+        budget = NODE_BUDGET_PER_CELL * BasicBoard<Box>::CELLS;
+        board = BasicBoard<Box>();
+        for (int box = 0; box < SIZE; box += Box) {
+            std::array<int, SIZE> nums;
+            std::iota(nums.begin(), nums.end(), 1);
+            rng.shuffle(nums.begin(), nums.end());
+
+            for (int i = 0; i < Box; i++) {
+                for (int j = 0; j < Box; j++) {
+                    board.place(box + i, box + j, nums[i * Box + j]);
+                }
+            }
+        }
+    } while (!solveGrid(board, rng, budget));
+}
+
+template <int Box>
+bool GridSynthesizer::solveGrid(BasicBoard<Box>& board, Random& rng, long& budget) {
+    const int SIZE = BasicBoard<Box>::SIZE;
+    if (--budget < 0) return false;
+    SUDOKU_STAT_ADD(nodeVisits, 1);
+
+    // Fill the most constrained cell next; in first-empty order the larger
+    // boards hit dead ends deep in the grid and never finish
+    int row = -1, col = -1, fewest = SIZE + 1;
+    for (int i = 0; i < SIZE && fewest > 1; i++) {
+        for (int j = 0; j < SIZE; j++) {
+            if (!board.isEmpty(i, j)) continue;
+            int count = board.candidateCount(i, j);
+            if (count < fewest) {
+                row = i;
+                col = j;
+                fewest = count;
+                if (fewest <= 1) break;
+            }
+        }
+    }
+
+    if (row == -1) {
+        return true; // Grid is complete
+    }
+
+    std::array<int, SIZE> nums;
+    std::iota(nums.begin(), nums.end(), 1);
+    rng.shuffle(nums.begin(), nums.end());
+
+    for (int num : nums) {
+        if (board.canPlace(row, col, num)) {
+            board.place(row, col, num);
+
+            if (solveGrid(board, rng, budget)) {
+                return true;
+            }
+
+            board.remove(row, col); // Backtrack
+            SUDOKU_STAT_ADD(backtracks, 1);
+            if (budget < 0) return false;
+        }
+    }
+
+    return false;
+}
+
+template <int Box>
+auto GridSynthesizer::seedGrids() -> const std::array<BasicBoard<Box>, SEED_GRIDS>& {
+    // Built once by the backtracking filler from fixed seeds, so the library,
+    // and with it every transformed grid, is the same on every run
+    static const std::array<BasicBoard<Box>, SEED_GRIDS> grids = [] {
+        std::array<BasicBoard<Box>, SEED_GRIDS> library;
+        for (int i = 0; i < SEED_GRIDS; i++) {
+            Random rng(static_cast<uint64_t>(i));
+            backtrackingGrid(library[i], rng);
+        }
+        return library;
+    }();
+    return grids;
+}
+
+template <int Box>
+void GridSynthesizer::transformedGrid(BasicBoard<Box>& board, Random& rng) {
+    const int SIZE = BasicBoard<Box>::SIZE;
+    const BasicBoard<Box>& seed = seedGrids<Box>()[rng.nextInt(SEED_GRIDS)];
+
+    // Source line of every target row and column: bands (stacks) move as
+    // blocks, then the lines inside each block are shuffled
+    std::array<int, SIZE> rows, cols;
+    for (std::array<int, SIZE>* lines : {&rows, &cols}) {
+        std::array<int, Box> blocks;
+        std::iota(blocks.begin(), blocks.end(), 0);
+        rng.shuffle(blocks.begin(), blocks.end());
+        for (int block = 0; block < Box; block++) {
+            std::array<int, Box> inner;
+            std::iota(inner.begin(), inner.end(), 0);
+            rng.shuffle(inner.begin(), inner.end());
+            for (int i = 0; i < Box; i++) {
+                (*lines)[block * Box + i] = blocks[block] * Box + inner[i];
+            }
+        }
+    }
+
+    // New label of every digit; 0 stays 0
+    std::array<int, SIZE + 1> digits;
+    std::iota(digits.begin(), digits.end(), 0);
+    rng.shuffle(digits.begin() + 1, digits.end());
+    bool transpose = rng.nextInt(2) != 0;
+
+    board = BasicBoard<Box>();
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col < SIZE; col++) {
+            int num = transpose ? seed.get(cols[col], rows[row]) : seed.get(rows[row], cols[col]);
+            board.place(row, col, digits[num]);
+        }
+    }
+}
+
+#define SUDOKU_INSTANTIATE_GRID_SYNTHESIZER(Box) \
+    template void GridSynthesizer::fill<Box>(BasicBoard<Box>&, Random&); \
+    template void GridSynthesizer::backtrackingGrid<Box>(BasicBoard<Box>&, Random&); \
+    template void GridSynthesizer::transformedGrid<Box>(BasicBoard<Box>&, Random&);
+
+SUDOKU_INSTANTIATE_GRID_SYNTHESIZER(2)
+SUDOKU_INSTANTIATE_GRID_SYNTHESIZER(3)
+SUDOKU_INSTANTIATE_GRID_SYNTHESIZER(4)
+SUDOKU_INSTANTIATE_GRID_SYNTHESIZER(5)
@@ -0,0 +1,117 @@
+#include "hint_engine.h"
+#include <type_traits>
+
+HintEngine::HintEngine() {}
+
+template <int Box>
+void HintEngine::reset(const BasicSudoku<Box>& board) {
+    State<Box>& engine = state.template emplace<State<Box>>(
+        State<Box>{BasicLogicalSolver<Box>(BasicBoard<Box>()), {}, true, 0, {}, false});
+    for (int cell = 0; cell < BasicBoard<Box>::CELLS; cell++) {
+        int row = cell / BasicBoard<Box>::SIZE, col = cell % BasicBoard<Box>::SIZE;
+        engine.solution[cell] = static_cast<uint8_t>(board.getSolution(row, col));
+        int num = board.getNumber(row, col);
+        engine.wrongCount += num != 0 && num != engine.solution[cell];
+    }
+}
+
+void HintEngine::cellChanged(int cell, int previous, int value) {
+    if (previous == value) return;
+    std::visit([&](auto& engine) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(engine)>, std::monostate>) {
+            // The solver only ever holds correct digits
+            int answer = engine.solution[cell];
+            if (previous != 0 && previous != answer) engine.wrongCount--;
+            if (value != 0 && value != answer) engine.wrongCount++;
+            if (previous != 0 && previous == answer) {
+                engine.stale = true;
+            } else if (value != 0 && value == answer && !engine.stale) {
+                engine.solver.place(cell, value);
+            }
+            engine.visible = false;
+        }
+    }, state);
+}
+
+template <int Box>
+void HintEngine::rebuildSolver(State<Box>& engine, const BasicSudoku<Box>& board) {
+    BasicBoard<Box> correct;
+    for (int row = 0; row < BasicBoard<Box>::SIZE; row++) {
+        for (int col = 0; col < BasicBoard<Box>::SIZE; col++) {
+            int num = board.getNumber(row, col);
+            if (num != 0 && num == board.getSolution(row, col)) {
+                correct.place(row, col, num);
+            }
+        }
+    }
+    engine.solver = BasicLogicalSolver<Box>(correct);
+    engine.stale = false;
+}
+
+template <int Box>
+bool HintEngine::findHint(const BasicSudoku<Box>& board, BasicHint<Box>& result) {
+    State<Box>* engine = std::get_if<State<Box>>(&state);
+    if (!engine) return false;
+    const int GRID_SIZE = BasicBoard<Box>::SIZE;
+
+    if (engine->wrongCount > 0) {
+        for (int cell = 0; cell < BasicBoard<Box>::CELLS; cell++) {
+            int num = board.getNumber(cell / GRID_SIZE, cell % GRID_SIZE);
+            if (num != 0 && num != engine->solution[cell]) {
+                result = BasicHint<Box>{true, cell / GRID_SIZE, cell % GRID_SIZE, 0, Technique::HiddenSingleBox, {}};
+                return true;
+            }
+        }
+    }
+    if (engine->stale) rebuildSolver(*engine, board);
+
+    // Eliminations cannot be shown on the board, so apply them and keep going
+    // until a placement turns up. The forcing chains are too slow to answer a
+    // keypress past 9x9, so the bigger boards stop at XY-Wing as in generation.
+    typedef BasicLogicalSolver<Box> LogicalSolverType;
+    const float ceiling = Box > 3 ? LogicalSolverType::techniqueRating(Technique::XYWing)
+                                  : LogicalSolverType::UNSOLVED_RATING;
+    typename LogicalSolverType::LogicalStep step;
+    result.support.reset();
+    result.technique = Technique::HiddenSingleBox;
+    while (engine->solver.findStep(step, ceiling)) {
+        result.support |= step.support;
+        if (LogicalSolverType::techniqueRating(step.technique) > LogicalSolverType::techniqueRating(result.technique)) {
+            result.technique = step.technique;
+        }
+        if (step.cell >= 0) {
+            result.mistake = false;
+            result.row = step.cell / GRID_SIZE;
+            result.col = step.cell % GRID_SIZE;
+            result.digit = step.digit;
+            return true;
+        }
+        engine->solver.apply(step);
+    }
+    return false;
+}
+
+template <int Box>
+bool HintEngine::showHint(const BasicSudoku<Box>& board) {
+    State<Box>* engine = std::get_if<State<Box>>(&state);
+    if (!engine) return false;
+    engine->visible = findHint(board, engine->hint);
+    return engine->visible;
+}
+
+template <int Box>
+const BasicHint<Box>* HintEngine::visibleHint() const {
+    const State<Box>* engine = std::get_if<State<Box>>(&state);
+    return engine && engine->visible ? &engine->hint : nullptr;
+}
+
+#define SUDOKU_INSTANTIATE_HINT_ENGINE(Box) \
+    template void HintEngine::reset<Box>(const BasicSudoku<Box>&); \
+    template bool HintEngine::findHint<Box>(const BasicSudoku<Box>&, BasicHint<Box>&); \
+    template bool HintEngine::showHint<Box>(const BasicSudoku<Box>&); \
+    template const BasicHint<Box>* HintEngine::visibleHint<Box>() const;
+
+SUDOKU_INSTANTIATE_HINT_ENGINE(2)
+SUDOKU_INSTANTIATE_HINT_ENGINE(3)
+SUDOKU_INSTANTIATE_HINT_ENGINE(4)
+SUDOKU_INSTANTIATE_HINT_ENGINE(5)
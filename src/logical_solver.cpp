@@ -0,0 +1,576 @@
+#include "logical_solver.h"
+#include "generation_stats.h"
+#include <algorithm>
+
+// Unit membership and peers of every cell, shared by all techniques
+template <int Box>
+struct LogicTables {
+    typedef BasicBoard<Box> Board;
+    static constexpr int PEERS = 2 * (Board::SIZE - 1) + (Box - 1) * (Box - 1);
+
+    int cellUnits[Board::CELLS][3];
+    int unitCells[Board::UNITS][Board::SIZE];
+    int peerList[Board::CELLS][PEERS];
+    std::bitset<Board::CELLS> unitSet[Board::UNITS];
+    std::bitset<Board::CELLS> peers[Board::CELLS];
+
+    LogicTables() {
+        for (int unit = 0; unit < Board::UNITS; unit++) {
+            for (int i = 0; i < Board::SIZE; i++) {
+                unitCells[unit][i] = Board::unitCell(unit, i);
+                unitSet[unit].set(unitCells[unit][i]);
+            }
+        }
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            int row = cell / Board::SIZE, col = cell % Board::SIZE;
+            cellUnits[cell][0] = row;
+            cellUnits[cell][1] = Board::SIZE + col;
+            cellUnits[cell][2] = 2 * Board::SIZE + Board::boxIndex(row, col);
+            peers[cell] = unitSet[cellUnits[cell][0]] | unitSet[cellUnits[cell][1]] | unitSet[cellUnits[cell][2]];
+            peers[cell].reset(cell);
+            int count = 0;
+            for (int other = 0; other < Board::CELLS; other++) {
+                if (peers[cell].test(other)) peerList[cell][count++] = other;
+            }
+        }
+    }
+};
+
+template <int Box>
+static const LogicTables<Box>& logicTables() {
+    static const LogicTables<Box> tables;
+    return tables;
+}
+
+// Next larger integer with the same number of set bits (Gosper's hack), used
+// to walk every k-element subset of a small set as a bitmask
+static int nextSubset(int subset) {
+    int lowest = subset & -subset;
+    int ripple = subset + lowest;
+    return (((ripple ^ subset) >> 2) / lowest) | ripple;
+}
+
+template <int Box>
+static void setPlacement(BasicLogicalStep<Box>& step, int cell, int digit) {
+    step.cell = cell;
+    step.digit = digit;
+    step.targets.reset();
+    step.eliminated = 0;
+    step.support.reset();
+}
+
+template <int Box>
+static void setElimination(BasicLogicalStep<Box>& step, const std::bitset<BasicBoard<Box>::CELLS>& targets,
+                           typename BasicBoard<Box>::Mask eliminated) {
+    step.cell = -1;
+    step.digit = 0;
+    step.targets = targets;
+    step.eliminated = eliminated;
+    step.support.reset();
+}
+
+template <int Box>
+BasicLogicalSolver<Box>::BasicLogicalSolver(const Board& board) : board(board), remaining(0) {
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        int row = cell / Board::SIZE, col = cell % Board::SIZE;
+        if (board.isEmpty(row, col)) {
+            candidates[cell] = board.candidates(row, col);
+            remaining++;
+        } else {
+            candidates[cell] = 0;
+        }
+    }
+}
+
+template <int Box>
+float BasicLogicalSolver<Box>::techniqueRating(Technique technique) {
+    switch (technique) {
+        case Technique::HiddenSingleBox: return 1.2f;
+        case Technique::HiddenSingleLine: return 1.5f;
+        case Technique::NakedSingle: return 2.3f;
+        case Technique::Pointing: return 2.6f;
+        case Technique::Claiming: return 2.8f;
+        case Technique::NakedPair: return 3.0f;
+        case Technique::XWing: return 3.2f;
+        case Technique::HiddenPair: return 3.4f;
+        case Technique::NakedTriple: return 3.6f;
+        case Technique::Swordfish: return 3.8f;
+        case Technique::HiddenTriple: return 4.0f;
+        case Technique::XYWing: return 4.2f;
+        case Technique::ForcingChain: return 7.0f;
+    }
+    return UNSOLVED_RATING;
+}
+
+template <int Box>
+const char* BasicLogicalSolver<Box>::techniqueName(Technique technique) {
+    switch (technique) {
+        case Technique::HiddenSingleBox: return "Hidden single (box)";
+        case Technique::HiddenSingleLine: return "Hidden single (line)";
+        case Technique::NakedSingle: return "Naked single";
+        case Technique::Pointing: return "Pointing";
+        case Technique::Claiming: return "Claiming";
+        case Technique::NakedPair: return "Naked pair";
+        case Technique::XWing: return "X-Wing";
+        case Technique::HiddenPair: return "Hidden pair";
+        case Technique::NakedTriple: return "Naked triple";
+        case Technique::Swordfish: return "Swordfish";
+        case Technique::HiddenTriple: return "Hidden triple";
+        case Technique::XYWing: return "XY-Wing";
+        case Technique::ForcingChain: return "Forcing chain";
+    }
+    return "Unknown";
+}
+
+template <int Box>
+float BasicLogicalSolver<Box>::rate(const Board& puzzle, float ceiling) {
+    SUDOKU_STAT_ADD(ratings, 1);
+    BasicLogicalSolver solver(puzzle);
+    LogicalStep step;
+    float rating = 0.0f;
+    while (solver.nextStep(step, ceiling)) {
+        rating = std::max(rating, techniqueRating(step.technique));
+    }
+    return solver.isSolved() ? rating : UNSOLVED_RATING;
+}
+
+template <int Box>
+bool BasicLogicalSolver<Box>::nextStep(LogicalStep& step, float ceiling) {
+    if (!findStep(step, ceiling)) return false;
+    apply(step);
+    return true;
+}
+
+template <int Box>
+bool BasicLogicalSolver<Box>::findStep(LogicalStep& step, float ceiling) const {
+    if (remaining == 0) return false;
+
+    // The ladder is ordered by rating, so the first hit is the easiest step
+    static const Technique ladder[] = {
+        Technique::HiddenSingleBox, Technique::HiddenSingleLine, Technique::NakedSingle,
+        Technique::Pointing, Technique::Claiming, Technique::NakedPair, Technique::XWing,
+        Technique::HiddenPair, Technique::NakedTriple, Technique::Swordfish,
+        Technique::HiddenTriple, Technique::XYWing, Technique::ForcingChain
+    };
+
+    for (Technique technique : ladder) {
+        if (techniqueRating(technique) > ceiling) break;
+
+        bool found = false;
+        switch (technique) {
+            case Technique::HiddenSingleBox: found = findHiddenSingle(true, step); break;
+            case Technique::HiddenSingleLine: found = findHiddenSingle(false, step); break;
+            case Technique::NakedSingle: found = findNakedSingle(step); break;
+            case Technique::Pointing: found = findIntersection(true, step); break;
+            case Technique::Claiming: found = findIntersection(false, step); break;
+            case Technique::NakedPair: found = findNakedSubset(2, step); break;
+            case Technique::XWing: found = findFish(2, step); break;
+            case Technique::HiddenPair: found = findHiddenSubset(2, step); break;
+            case Technique::NakedTriple: found = findNakedSubset(3, step); break;
+            case Technique::Swordfish: found = findFish(3, step); break;
+            case Technique::HiddenTriple: found = findHiddenSubset(3, step); break;
+            case Technique::XYWing: found = findXYWing(step); break;
+            case Technique::ForcingChain: found = findForcingChain(step); break;
+        }
+
+        if (found) {
+            step.technique = technique;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <int Box>
+void BasicLogicalSolver<Box>::place(int cell, int num) {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    board.place(cell / Board::SIZE, cell % Board::SIZE, num);
+    candidates[cell] = 0;
+    remaining--;
+
+    Mask mask = static_cast<Mask>(~Board::bit(num));
+    for (int peer : tables.peerList[cell]) {
+        candidates[peer] &= mask;
+    }
+}
+
+template <int Box>
+void BasicLogicalSolver<Box>::apply(const LogicalStep& step) {
+    if (step.cell >= 0) {
+        place(step.cell, step.digit);
+        return;
+    }
+    Mask keep = static_cast<Mask>(~step.eliminated);
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        if (step.targets.test(cell)) candidates[cell] &= keep;
+    }
+}
+
+// Places naked and hidden singles until none are left. False when the board
+// runs into a contradiction: a cell or a digit with nowhere to go.
+template <int Box>
+bool BasicLogicalSolver<Box>::propagateSingles() {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    bool progress = true;
+    while (progress && remaining > 0) {
+        progress = false;
+
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            Mask mask = candidates[cell];
+            if (mask == 0) {
+                if (board.getCell(cell) == 0) return false;
+                continue;
+            }
+            if ((mask & (mask - 1)) == 0) {
+                place(cell, Board::lowestDigit(mask));
+                progress = true;
+            }
+        }
+
+        for (int unit = 0; unit < Board::UNITS; unit++) {
+            Mask once = 0, twice = 0;
+            for (int cell : tables.unitCells[unit]) {
+                twice |= once & candidates[cell];
+                once |= candidates[cell];
+            }
+            if ((once | board.unitMask(unit)) != Board::ALL_DIGITS) return false;
+
+            Mask hidden = once & ~twice;
+            if (hidden == 0) continue;
+            int num = Board::lowestDigit(hidden);
+            for (int cell : tables.unitCells[unit]) {
+                if (candidates[cell] & Board::bit(num)) {
+                    place(cell, num);
+                    break;
+                }
+            }
+            progress = true;
+        }
+    }
+    return true;
+}
+
+template <int Box>
+bool BasicLogicalSolver<Box>::findHiddenSingle(bool boxes, LogicalStep& step) const {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    int first = boxes ? 2 * Board::SIZE : 0;
+    int last = boxes ? Board::UNITS : 2 * Board::SIZE;
+    for (int unit = first; unit < last; unit++) {
+        Mask once = 0, twice = 0;
+        for (int cell : tables.unitCells[unit]) {
+            twice |= once & candidates[cell];
+            once |= candidates[cell];
+        }
+        Mask hidden = once & ~twice;
+        if (hidden == 0) continue;
+
+        int num = Board::lowestDigit(hidden);
+        for (int cell : tables.unitCells[unit]) {
+            if (candidates[cell] & Board::bit(num)) {
+                setPlacement(step, cell, num);
+                step.support = tables.unitSet[unit];
+                step.support.reset(cell);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <int Box>
+bool BasicLogicalSolver<Box>::findNakedSingle(LogicalStep& step) const {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        Mask mask = candidates[cell];
+        if (mask == 0 || (mask & (mask - 1)) != 0) continue;
+
+        setPlacement(step, cell, Board::lowestDigit(mask));
+        for (int peer : tables.peerList[cell]) {
+            if (board.getCell(peer) != 0) step.support.set(peer);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Pointing: a digit confined to one line inside a box leaves the rest of that
+// line. Claiming: a digit confined to one box inside a line leaves the rest of
+// that box.
+template <int Box>
+bool BasicLogicalSolver<Box>::findIntersection(bool pointing, LogicalStep& step) const {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    int first = pointing ? 2 * Board::SIZE : 0;
+    int last = pointing ? Board::UNITS : 2 * Board::SIZE;
+    for (int unit = first; unit < last; unit++) {
+        for (Mask digits = ~board.unitMask(unit) & Board::ALL_DIGITS; digits; digits &= digits - 1) {
+            Mask bit = static_cast<Mask>(digits & (0u - digits));
+
+            // Units shared by every cell of this unit that still holds the digit
+            int shared[2] = {-1, -1};
+            bool any = false;
+            std::bitset<Board::CELLS> support;
+            for (int cell : tables.unitCells[unit]) {
+                if (!(candidates[cell] & bit)) continue;
+                support.set(cell);
+                const int* units = tables.cellUnits[cell];
+                int other[2] = {pointing ? units[0] : units[2], pointing ? units[1] : units[2]};
+                if (!any) {
+                    shared[0] = other[0];
+                    shared[1] = other[1];
+                    any = true;
+                } else {
+                    if (shared[0] != other[0]) shared[0] = -1;
+                    if (shared[1] != other[1]) shared[1] = -1;
+                }
+            }
+            if (!any) continue;
+
+            for (int target : shared) {
+                if (target < 0) continue;
+                std::bitset<Board::CELLS> targets;
+                for (int cell : tables.unitCells[target]) {
+                    if ((candidates[cell] & bit) && !tables.unitSet[unit].test(cell)) targets.set(cell);
+                }
+                if (targets.none()) continue;
+
+                setElimination(step, targets, bit);
+                step.support = support;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// size cells of a unit holding only size digits between them
+template <int Box>
+bool BasicLogicalSolver<Box>::findNakedSubset(int size, LogicalStep& step) const {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    for (int unit = 0; unit < Board::UNITS; unit++) {
+        int cells[Board::SIZE];
+        int count = 0;
+        for (int cell : tables.unitCells[unit]) {
+            int candidateCount = Board::popcount(candidates[cell]);
+            if (candidateCount >= 2 && candidateCount <= size) cells[count++] = cell;
+        }
+        if (count < size) continue;
+
+        for (int pick = (1 << size) - 1; pick < (1 << count); pick = nextSubset(pick)) {
+            Mask digits = 0;
+            std::bitset<Board::CELLS> support;
+            for (int i = 0; i < count; i++) {
+                if (pick & (1 << i)) {
+                    digits |= candidates[cells[i]];
+                    support.set(cells[i]);
+                }
+            }
+            if (Board::popcount(digits) != size) continue;
+
+            std::bitset<Board::CELLS> targets;
+            for (int cell : tables.unitCells[unit]) {
+                if (!support.test(cell) && (candidates[cell] & digits)) targets.set(cell);
+            }
+            if (targets.none()) continue;
+
+            setElimination(step, targets, digits);
+            step.support = support;
+            return true;
+        }
+    }
+    return false;
+}
+
+// size digits of a unit that fit in only size cells between them
+template <int Box>
+bool BasicLogicalSolver<Box>::findHiddenSubset(int size, LogicalStep& step) const {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    for (int unit = 0; unit < Board::UNITS; unit++) {
+        int digits[Board::SIZE];
+        Mask places[Board::SIZE];
+        int count = 0;
+        for (int num = 1; num <= Board::SIZE; num++) {
+            Mask where = 0;
+            for (int i = 0; i < Board::SIZE; i++) {
+                if (candidates[tables.unitCells[unit][i]] & Board::bit(num)) where |= 1u << i;
+            }
+            int placeCount = Board::popcount(where);
+            if (placeCount >= 2 && placeCount <= size) {
+                digits[count] = num;
+                places[count++] = where;
+            }
+        }
+        if (count < size) continue;
+
+        for (int pick = (1 << size) - 1; pick < (1 << count); pick = nextSubset(pick)) {
+            Mask where = 0, kept = 0;
+            for (int i = 0; i < count; i++) {
+                if (pick & (1 << i)) {
+                    where |= places[i];
+                    kept |= Board::bit(digits[i]);
+                }
+            }
+            if (Board::popcount(where) != size) continue;
+
+            std::bitset<Board::CELLS> cells, targets;
+            for (int i = 0; i < Board::SIZE; i++) {
+                if (!(where & (1u << i))) continue;
+                int cell = tables.unitCells[unit][i];
+                cells.set(cell);
+                if (candidates[cell] & ~kept) targets.set(cell);
+            }
+            if (targets.none()) continue;
+
+            setElimination(step, targets, static_cast<Mask>(~kept & Board::ALL_DIGITS));
+            step.support = cells;
+            return true;
+        }
+    }
+    return false;
+}
+
+// X-Wing (size 2) and Swordfish (size 3): a digit confined to size columns
+// across size rows leaves those columns everywhere else, and vice versa
+template <int Box>
+bool BasicLogicalSolver<Box>::findFish(int size, LogicalStep& step) const {
+    for (int num = 1; num <= Board::SIZE; num++) {
+        Mask bit = Board::bit(num);
+        for (int byColumn = 0; byColumn < 2; byColumn++) {
+            int lines[Board::SIZE];
+            Mask places[Board::SIZE];
+            int count = 0;
+            for (int line = 0; line < Board::SIZE; line++) {
+                Mask where = 0;
+                for (int i = 0; i < Board::SIZE; i++) {
+                    int cell = byColumn ? i * Board::SIZE + line : line * Board::SIZE + i;
+                    if (candidates[cell] & bit) where |= 1u << i;
+                }
+                int placeCount = Board::popcount(where);
+                if (placeCount >= 2 && placeCount <= size) {
+                    lines[count] = line;
+                    places[count++] = where;
+                }
+            }
+            if (count < size) continue;
+
+            for (int pick = (1 << size) - 1; pick < (1 << count); pick = nextSubset(pick)) {
+                Mask cover = 0, base = 0;
+                for (int i = 0; i < count; i++) {
+                    if (pick & (1 << i)) {
+                        cover |= places[i];
+                        base |= 1u << lines[i];
+                    }
+                }
+                if (Board::popcount(cover) != size) continue;
+
+                std::bitset<Board::CELLS> targets, support;
+                for (int line = 0; line < Board::SIZE; line++) {
+                    for (int i = 0; i < Board::SIZE; i++) {
+                        if (!(cover & (1u << i))) continue;
+                        int cell = byColumn ? i * Board::SIZE + line : line * Board::SIZE + i;
+                        if (!(candidates[cell] & bit)) continue;
+                        if (base & (1u << line)) {
+                            support.set(cell);
+                        } else {
+                            targets.set(cell);
+                        }
+                    }
+                }
+                if (targets.none()) continue;
+
+                setElimination(step, targets, bit);
+                step.support = support;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Pivot {x,y} seeing pincers {x,z} and {y,z}: whichever digit the pivot
+// takes, one pincer is z, so z leaves every cell that sees both pincers
+template <int Box>
+bool BasicLogicalSolver<Box>::findXYWing(LogicalStep& step) const {
+    const LogicTables<Box>& tables = logicTables<Box>();
+    for (int pivot = 0; pivot < Board::CELLS; pivot++) {
+        Mask pivotMask = candidates[pivot];
+        if (Board::popcount(pivotMask) != 2) continue;
+
+        for (int first : tables.peerList[pivot]) {
+            Mask firstMask = candidates[first];
+            if (Board::popcount(firstMask) != 2 || Board::popcount(firstMask & pivotMask) != 1) continue;
+
+            Mask z = firstMask & ~pivotMask;
+            Mask secondMask = (pivotMask & ~firstMask) | z;
+            for (int second : tables.peerList[pivot]) {
+                if (second == first || candidates[second] != secondMask) continue;
+
+                std::bitset<Board::CELLS> targets;
+                for (int cell : tables.peerList[first]) {
+                    if (cell != second && (candidates[cell] & z) && tables.peers[second].test(cell)) targets.set(cell);
+                }
+                if (targets.none()) continue;
+
+                setElimination(step, targets, z);
+                step.support.set(pivot);
+                step.support.set(first);
+                step.support.set(second);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Tries both digits of a two-candidate cell and follows the singles each one
+// forces. A branch that ends in a contradiction proves the other digit; a
+// conclusion both branches reach holds either way.
+template <int Box>
+bool BasicLogicalSolver<Box>::findForcingChain(LogicalStep& step) const {
+    for (int origin = 0; origin < Board::CELLS; origin++) {
+        Mask mask = candidates[origin];
+        if (Board::popcount(mask) != 2) continue;
+
+        int first = Board::lowestDigit(mask);
+        int second = Board::lowestDigit(mask & (mask - 1));
+        BasicLogicalSolver left = *this, right = *this;
+        left.place(origin, first);
+        right.place(origin, second);
+        bool leftHolds = left.propagateSingles();
+        bool rightHolds = right.propagateSingles();
+        if (leftHolds == rightHolds && !leftHolds) continue;
+
+        if (!leftHolds || !rightHolds) {
+            setPlacement(step, origin, leftHolds ? first : second);
+            step.support.set(origin);
+            return true;
+        }
+
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            int num = left.board.getCell(cell);
+            if (candidates[cell] == 0 || num == 0 || num != right.board.getCell(cell)) continue;
+            setPlacement(step, cell, num);
+            step.support.set(origin);
+            return true;
+        }
+
+        for (int cell = 0; cell < Board::CELLS; cell++) {
+            if (candidates[cell] == 0) continue;
+            Mask leftMask = left.candidates[cell] | (left.board.getCell(cell) ? Board::bit(left.board.getCell(cell)) : 0);
+            Mask rightMask = right.candidates[cell] | (right.board.getCell(cell) ? Board::bit(right.board.getCell(cell)) : 0);
+            Mask gone = candidates[cell] & ~(leftMask | rightMask);
+            if (gone == 0) continue;
+
+            std::bitset<Board::CELLS> targets;
+            targets.set(cell);
+            setElimination(step, targets, gone);
+            step.support.set(origin);
+            return true;
+        }
+    }
+    return false;
+}
+
+template class BasicLogicalSolver<2>;
+template class BasicLogicalSolver<3>;
+template class BasicLogicalSolver<4>;
+template class BasicLogicalSolver<5>;
@@ -1,7 +1,42 @@
 #include "game.h"
+#include "solver.h"
+#include "grid_synthesizer.h"
+#include "generation_stats.h"
+#include <cstdlib>
 #include <iostream>
+#include <string>
 
 int main(int, char**) {
+    // SUDOKU_SOLVER=dlx|backtracking picks the solution counting backend
+    if (const char* backendName = std::getenv("SUDOKU_SOLVER")) {
+        SolverBackend backend;
+        if (Solver::parseBackend(backendName, backend)) {
+            Solver::setBackend(backend);
+        } else {
+            std::cerr << "Unknown SUDOKU_SOLVER '" << backendName << "', using "
+                      << Solver::backendName(Solver::getBackend()) << std::endl;
+        }
+    }
+
+    // SUDOKU_GRIDS=backtracking|transform picks where solution grids come from
+    if (const char* sourceName = std::getenv("SUDOKU_GRIDS")) {
+        GridSource source;
+        if (GridSynthesizer::parseSource(sourceName, source)) {
+            GridSynthesizer::setSource(source);
+        } else {
+            std::cerr << "Unknown SUDOKU_GRIDS '" << sourceName << "', using "
+                      << GridSynthesizer::sourceName(GridSynthesizer::getSource()) << std::endl;
+        }
+    }
+
+    // SUDOKU_STATS=1 logs what generating each puzzle cost, in STATS=1 builds
+    if (const char* stats = std::getenv("SUDOKU_STATS")) {
+        GenerationStats::setLogging(std::string(stats) == "1");
+        if (!GenerationStats::ENABLED && GenerationStats::isLogging()) {
+            std::cerr << "SUDOKU_STATS needs a build with STATS=1" << std::endl;
+        }
+    }
+
     Game game;
     
     if (!game.init()) {
@@ -11,4 +46,4 @@ int main(int, char**) {
 
     game.run();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,159 @@
+#include "move_journal.h"
+#include "byte_order.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+static const char JOURNAL_MAGIC[4] = {'S', 'D', 'K', 'J'};
+static const uint16_t JOURNAL_VERSION = 2;
+static const std::size_t HEADER_SIZE = 12;
+static const std::size_t MOVE_SIZE = 6;
+
+MoveJournal::MoveJournal() : cursor(0), boxSize(0), lastTicks(0), listener(nullptr) {}
+
+// Size of a saved game of the given box size
+static std::size_t stateSize(int box) {
+    switch (box) {
+        case 2: return BasicSudoku<2>::STATE_SIZE;
+        case 3: return BasicSudoku<3>::STATE_SIZE;
+        case 4: return BasicSudoku<4>::STATE_SIZE;
+        case 5: return BasicSudoku<5>::STATE_SIZE;
+        default: return 0;
+    }
+}
+
+template <int Box>
+void MoveJournal::start(const BasicSudoku<Box>& board, uint32_t ticks) {
+    moves.clear();
+    cursor = 0;
+    boxSize = Box;
+    startState.resize(BasicSudoku<Box>::STATE_SIZE);
+    board.writeState(startState.data());
+    lastTicks = ticks;
+}
+
+template <int Box>
+bool MoveJournal::play(BasicSudoku<Box>& board, int row, int col, int num, uint32_t ticks) {
+    Move move;
+    move.cell = static_cast<uint16_t>(row * BasicSudoku<Box>::GRID_SIZE + col);
+    move.previous = static_cast<uint8_t>(board.getNumber(row, col));
+    move.value = static_cast<uint8_t>(num);
+    if (!board.playMove(row, col, num, move.effects)) return false;
+
+    move.delay = static_cast<uint16_t>(std::min<uint32_t>(ticks - lastTicks, UINT16_MAX));
+    lastTicks = ticks;
+    moves.resize(cursor);  // An undone move cannot be redone past a new one
+    moves.push_back(move);
+    cursor++;
+    if (listener) listener->cellChanged(move.cell, move.previous, move.value);
+    return true;
+}
+
+template <int Box>
+bool MoveJournal::undo(BasicSudoku<Box>& board) {
+    if (!canUndo()) return false;
+    const Move& move = moves[--cursor];
+    board.revertMove(move.cell / BasicSudoku<Box>::GRID_SIZE, move.cell % BasicSudoku<Box>::GRID_SIZE,
+                     move.previous, move.effects);
+    if (listener) listener->cellChanged(move.cell, move.value, move.previous);
+    return true;
+}
+
+template <int Box>
+bool MoveJournal::redo(BasicSudoku<Box>& board) {
+    if (!canRedo()) return false;
+    Move& move = moves[cursor++];
+    if (!board.playMove(move.cell / BasicSudoku<Box>::GRID_SIZE, move.cell % BasicSudoku<Box>::GRID_SIZE,
+                        move.value, move.effects)) {
+        return false;
+    }
+    if (listener) listener->cellChanged(move.cell, move.previous, move.value);
+    return true;
+}
+
+template <int Box>
+bool MoveJournal::startingBoard(BasicSudoku<Box>& board) const {
+    return boxSize == Box && board.readState(startState.data());
+}
+
+template <int Box>
+bool MoveJournal::replay(BasicSudoku<Box>& board) {
+    if (boxSize != Box) return false;
+    for (std::size_t i = 0; i < cursor; i++) {
+        Move& move = moves[i];
+        int row = move.cell / BasicSudoku<Box>::GRID_SIZE, col = move.cell % BasicSudoku<Box>::GRID_SIZE;
+        if (board.getNumber(row, col) != move.previous || !board.playMove(row, col, move.value, move.effects)) {
+            return false;
+        }
+        if (listener) listener->cellChanged(move.cell, move.previous, move.value);
+    }
+    return true;
+}
+
+bool MoveJournal::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(JOURNAL_MAGIC, 4);
+    writeLE(out, JOURNAL_VERSION, 2);
+    writeLE(out, static_cast<uint64_t>(boxSize), 1);
+    writeLE(out, 0, 1);
+    writeLE(out, cursor, 4);
+    out.write(reinterpret_cast<const char*>(startState.data()), static_cast<std::streamsize>(startState.size()));
+    for (std::size_t i = 0; i < cursor; i++) {
+        writeLE(out, moves[i].cell, 2);
+        writeLE(out, moves[i].previous, 1);
+        writeLE(out, moves[i].value, 1);
+        writeLE(out, moves[i].delay, 2);
+    }
+    return static_cast<bool>(out);
+}
+
+bool MoveJournal::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), JOURNAL_MAGIC, 4) != 0 ||
+        readLE(&data[4], 2) != JOURNAL_VERSION) {
+        return false;
+    }
+    int box = static_cast<int>(data[6]);
+    std::size_t state = stateSize(box);
+    std::size_t cells = static_cast<std::size_t>(box * box * box * box);
+    std::size_t count = readLE(&data[8], 4);
+    if (state == 0 || data.size() != HEADER_SIZE + state + count * MOVE_SIZE) return false;
+
+    boxSize = box;
+    startState.assign(&data[HEADER_SIZE], &data[HEADER_SIZE] + state);
+    moves.clear();
+    cursor = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        const unsigned char* record = &data[HEADER_SIZE] + state + i * MOVE_SIZE;
+        Move move;
+        move.cell = static_cast<uint16_t>(readLE(record, 2));
+        move.previous = record[2];
+        move.value = record[3];
+        move.delay = static_cast<uint16_t>(readLE(record + 4, 2));
+        move.effects = 0;
+        if (move.cell >= cells || move.previous > box * box || move.value > box * box) return false;
+        moves.push_back(move);
+    }
+    cursor = moves.size();
+    lastTicks = 0;
+    return true;
+}
+
+#define SUDOKU_INSTANTIATE_MOVE_JOURNAL(Box) \
+    template void MoveJournal::start<Box>(const BasicSudoku<Box>&, uint32_t); \
+    template bool MoveJournal::play<Box>(BasicSudoku<Box>&, int, int, int, uint32_t); \
+    template bool MoveJournal::undo<Box>(BasicSudoku<Box>&); \
+    template bool MoveJournal::redo<Box>(BasicSudoku<Box>&); \
+    template bool MoveJournal::startingBoard<Box>(BasicSudoku<Box>&) const; \
+    template bool MoveJournal::replay<Box>(BasicSudoku<Box>&);
+
+SUDOKU_INSTANTIATE_MOVE_JOURNAL(2)
+SUDOKU_INSTANTIATE_MOVE_JOURNAL(3)
+SUDOKU_INSTANTIATE_MOVE_JOURNAL(4)
+SUDOKU_INSTANTIATE_MOVE_JOURNAL(5)
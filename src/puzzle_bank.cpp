@@ -0,0 +1,239 @@
+#include "puzzle_bank.h"
+#include "byte_order.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char BANK_MAGIC[4] = {'S', 'D', 'K', 'B'};
+static const uint16_t BANK_VERSION = 1;
+static const std::size_t HEADER_SIZE = 16;
+static const std::size_t BUCKET_ENTRY_SIZE = 16;
+
+// Records come straight from the file, so every digit is checked before it
+// reaches the board's masks; false for a value past 9 or a repeated digit
+static bool unpackBoard(const unsigned char* packed, Board& board) {
+    board = Board();
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        int num = (packed[cell / 2] >> (cell % 2 ? 4 : 0)) & 0xF;
+        if (num == 0) continue;
+        int row = cell / Board::SIZE, col = cell % Board::SIZE;
+        if (num > Board::SIZE || !board.canPlace(row, col, num)) return false;
+        board.place(row, col, num);
+    }
+    return true;
+}
+
+// A usable record is a full solution whose givens the puzzle copies
+static bool unpackRecord(const unsigned char* record, Board& puzzle, Board& solution) {
+    if (!unpackBoard(record, puzzle) || !unpackBoard(record + PuzzleBank::PACKED_BOARD_SIZE, solution)) {
+        return false;
+    }
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        int given = puzzle.getCell(cell);
+        if (solution.getCell(cell) == 0 || (given != 0 && given != solution.getCell(cell))) return false;
+    }
+    return true;
+}
+
+static void packBoard(const Board& board, unsigned char* packed) {
+    std::memset(packed, 0, PuzzleBank::PACKED_BOARD_SIZE);
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        packed[cell / 2] |= static_cast<unsigned char>(board.getCell(cell) << (cell % 2 ? 4 : 0));
+    }
+}
+
+PuzzleBank::PuzzleBank() : data(nullptr), size(0)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{}
+
+PuzzleBank::~PuzzleBank() {
+    close();
+}
+
+int PuzzleBank::bucketFor(float difficulty) {
+    int bucket = static_cast<int>(difficulty * BUCKETS);
+    return std::max(0, std::min(BUCKETS - 1, bucket));
+}
+
+float PuzzleBank::bucketDifficulty(int bucket) {
+    return (bucket + 0.5f) / BUCKETS;
+}
+
+bool PuzzleBank::open(const std::string& path) {
+    close();
+    if (!mapFile(path)) {
+        return false;
+    }
+
+    // Validate the header and bucket table before trusting any offsets
+    std::size_t tableEnd = HEADER_SIZE + BUCKETS * BUCKET_ENTRY_SIZE;
+    if (size < tableEnd || std::memcmp(data, BANK_MAGIC, 4) != 0 ||
+        readLE(data + 4, 2) != BANK_VERSION || readLE(data + 6, 2) != BUCKETS ||
+        readLE(data + 8, 4) != RECORD_SIZE) {
+        close();
+        return false;
+    }
+
+    std::random_device rd;
+    std::mt19937_64 gen(rd());
+    for (int i = 0; i < BUCKETS; i++) {
+        const unsigned char* entry = data + HEADER_SIZE + i * BUCKET_ENTRY_SIZE;
+        Bucket bucket{readLE(entry, 8), readLE(entry + 8, 8), 0, 1, 0};
+        if (bucket.offset < tableEnd || bucket.offset > size ||
+            bucket.count > (size - bucket.offset) / RECORD_SIZE) {
+            close();
+            return false;
+        }
+        if (bucket.count > 1) {
+            bucket.start = gen() % bucket.count;
+            bucket.stride = 1 + gen() % (bucket.count - 1);
+            while (std::gcd(bucket.stride, bucket.count) != 1) {
+                bucket.stride++;
+            }
+        }
+        buckets.push_back(bucket);
+    }
+    return true;
+}
+
+void PuzzleBank::close() {
+    unmapFile();
+    buckets.clear();
+}
+
+std::size_t PuzzleBank::remaining(int bucket) const {
+    if (!isOpen()) return 0;
+    const Bucket& b = buckets[bucket];
+    return static_cast<std::size_t>(b.count - b.served);
+}
+
+bool PuzzleBank::take(float difficulty, Board& puzzle, Board& solution) {
+    if (!isOpen()) return false;
+
+    // A corrupt record is skipped; once the bucket runs out the caller
+    // generates live instead
+    Bucket& bucket = buckets[bucketFor(difficulty)];
+    while (bucket.served < bucket.count) {
+        uint64_t index = (bucket.start + bucket.served * bucket.stride) % bucket.count;
+        bucket.served++;
+        if (unpackRecord(data + bucket.offset + index * RECORD_SIZE, puzzle, solution)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PuzzleBank::write(const std::string& path, const std::vector<BankEntry>& entries) {
+    std::vector<std::vector<const BankEntry*>> byBucket(BUCKETS);
+    for (const auto& entry : entries) {
+        byBucket[std::max(0, std::min(BUCKETS - 1, entry.bucket))].push_back(&entry);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(BANK_MAGIC, 4);
+    writeLE(out, BANK_VERSION, 2);
+    writeLE(out, BUCKETS, 2);
+    writeLE(out, RECORD_SIZE, 4);
+    writeLE(out, 0, 4);
+
+    uint64_t offset = HEADER_SIZE + BUCKETS * BUCKET_ENTRY_SIZE;
+    for (const auto& bucket : byBucket) {
+        writeLE(out, offset, 8);
+        writeLE(out, bucket.size(), 8);
+        offset += bucket.size() * RECORD_SIZE;
+    }
+
+    unsigned char record[RECORD_SIZE];
+    for (const auto& bucket : byBucket) {
+        for (const BankEntry* entry : bucket) {
+            packBoard(entry->puzzle, record);
+            packBoard(entry->solution, record + PACKED_BOARD_SIZE);
+            out.write(reinterpret_cast<const char*>(record), RECORD_SIZE);
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+#ifdef _WIN32
+
+bool PuzzleBank::mapFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void PuzzleBank::unmapFile() {
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+#else
+
+bool PuzzleBank::mapFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping stays valid without the descriptor
+    if (view == MAP_FAILED) return false;
+
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void PuzzleBank::unmapFile() {
+    if (data) munmap(const_cast<unsigned char*>(data), size);
+    data = nullptr;
+    size = 0;
+}
+
+#endif
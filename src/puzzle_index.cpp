@@ -0,0 +1,88 @@
+#include "puzzle_index.h"
+#include <algorithm>
+
+PuzzleIndex* PuzzleIndex::activeIndex = nullptr;
+
+static const std::size_t MIN_CAPACITY = 1024;
+
+static bool isEmptySlot(const PuzzleHash& slot) {
+    return slot.high == 0 && slot.low == 0;
+}
+
+// Smallest power of two that keeps expected entries under 3/4 load
+static std::size_t capacityFor(std::size_t expected) {
+    std::size_t capacity = MIN_CAPACITY;
+    while (capacity / 4 * 3 < expected) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+PuzzleIndex::PuzzleIndex(std::size_t expected)
+    : slots(capacityFor(expected), PuzzleHash{0, 0}), count(0), rejected(0) {}
+
+bool PuzzleIndex::insert(const PuzzleHash& hash) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t slot = findSlot(hash);
+    if (!isEmptySlot(slots[slot])) {
+        rejected++;
+        return false;
+    }
+    slots[slot] = hash;
+    count++;
+    if (count > slots.size() / 4 * 3) {
+        rehash(slots.size() * 2);
+    }
+    return true;
+}
+
+bool PuzzleIndex::contains(const PuzzleHash& hash) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !isEmptySlot(slots[findSlot(hash)]);
+}
+
+void PuzzleIndex::reserve(std::size_t expected) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t capacity = capacityFor(expected);
+    if (capacity > slots.size()) {
+        rehash(capacity);
+    }
+}
+
+void PuzzleIndex::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::fill(slots.begin(), slots.end(), PuzzleHash{0, 0});
+    count = 0;
+    rejected = 0;
+}
+
+std::size_t PuzzleIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
+
+std::size_t PuzzleIndex::duplicates() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return rejected;
+}
+
+// Slot holding hash, or the empty slot where it would go. The hash is
+// already well mixed, so its low bits pick the home slot directly.
+std::size_t PuzzleIndex::findSlot(const PuzzleHash& hash) const {
+    std::size_t mask = slots.size() - 1;
+    std::size_t slot = static_cast<std::size_t>(hash.low) & mask;
+    while (!isEmptySlot(slots[slot]) && slots[slot] != hash) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void PuzzleIndex::rehash(std::size_t capacity) {
+    std::vector<PuzzleHash> old(capacity, PuzzleHash{0, 0});
+    old.swap(slots);
+    for (const PuzzleHash& hash : old) {
+        if (!isEmptySlot(hash)) {
+            slots[findSlot(hash)] = hash;
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include "puzzle_prefetcher.h"
+
+PuzzlePrefetcher::PuzzlePrefetcher(int depth)
+    : ready(PuzzleBank::BUCKETS), bank(nullptr), depth(depth), preferredDifficulty(0.5f), stopping(false) {}
+
+PuzzlePrefetcher::~PuzzlePrefetcher() {
+    stop();
+}
+
+void PuzzlePrefetcher::start(PuzzleBank* puzzleBank) {
+    if (worker.joinable()) return;
+    bank = puzzleBank;
+    stopping = false;
+    worker = std::thread(&PuzzlePrefetcher::workerLoop, this);
+}
+
+void PuzzlePrefetcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workNeeded.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PuzzlePrefetcher::setDifficulty(float difficulty) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        preferredDifficulty = difficulty;
+    }
+    workNeeded.notify_one();
+}
+
+Sudoku PuzzlePrefetcher::take(float difficulty) {
+    std::unique_lock<std::mutex> lock(mutex);
+    preferredDifficulty = difficulty;
+    if (!worker.joinable()) {
+        lock.unlock();
+        return makePuzzle(difficulty);
+    }
+
+    std::deque<Sudoku>& bucket = ready[PuzzleBank::bucketFor(difficulty)];
+    workNeeded.notify_one();
+    puzzleReady.wait(lock, [&bucket] { return !bucket.empty(); });
+
+    Sudoku puzzle = std::move(bucket.front());
+    bucket.pop_front();
+    workNeeded.notify_one();  // Refill what was just handed out
+    return puzzle;
+}
+
+bool PuzzlePrefetcher::tryTake(float difficulty, Sudoku& puzzle) {
+    std::unique_lock<std::mutex> lock(mutex);
+    preferredDifficulty = difficulty;
+    if (!worker.joinable()) {
+        lock.unlock();
+        puzzle = makePuzzle(difficulty);
+        return true;
+    }
+
+    std::deque<Sudoku>& bucket = ready[PuzzleBank::bucketFor(difficulty)];
+    workNeeded.notify_one();
+    if (bucket.empty()) return false;
+
+    puzzle = std::move(bucket.front());
+    bucket.pop_front();
+    workNeeded.notify_one();  // Refill what was just handed out
+    return true;
+}
+
+std::size_t PuzzlePrefetcher::readyCount(float difficulty) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready[PuzzleBank::bucketFor(difficulty)].size();
+}
+
+// Preferred bucket first, then any bucket below its target depth
+int PuzzlePrefetcher::nextBucketToFill() const {
+    int preferred = PuzzleBank::bucketFor(preferredDifficulty);
+    if (static_cast<int>(ready[preferred].size()) < depth) return preferred;
+    for (int bucket = 0; bucket < PuzzleBank::BUCKETS; bucket++) {
+        if (static_cast<int>(ready[bucket].size()) < depth) return bucket;
+    }
+    return -1;
+}
+
+Sudoku PuzzlePrefetcher::makePuzzle(float difficulty) {
+    Board puzzle, answer;
+    if (bank && bank->take(difficulty, puzzle, answer)) {
+        return Sudoku(puzzle, answer, difficulty);
+    }
+    return Sudoku(difficulty);
+}
+
+void PuzzlePrefetcher::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        int bucket = nextBucketToFill();
+        if (bucket < 0) {
+            workNeeded.wait(lock);
+            continue;
+        }
+
+        // The preferred bucket gets the exact slider value, others their center
+        float difficulty = bucket == PuzzleBank::bucketFor(preferredDifficulty)
+            ? preferredDifficulty : PuzzleBank::bucketDifficulty(bucket);
+
+        lock.unlock();
+        Sudoku puzzle = makePuzzle(difficulty);
+        lock.lock();
+
+        ready[bucket].push_back(std::move(puzzle));
+        puzzleReady.notify_all();
+    }
+}
@@ -1,6 +1,7 @@
 #include "renderer.h"
 #include "game.h"
 #include <stdexcept>
+#include <algorithm>
 #include <array>
 #include <sstream>
 #include <iostream>
@@ -9,7 +10,23 @@
 SDL_Texture* Renderer::cachedBackground = nullptr;  // Define static member
 SDL_Texture *Renderer::resetTexture = nullptr;
 
-Renderer::Renderer() : window(nullptr), renderer(nullptr), font(nullptr) {}
+// Colors of the atlas inks, indexed by GlyphInk
+static const SDL_Color GLYPH_INK_COLORS[] = {
+    {47, 79, 79, 255},     // Fixed, light theme
+    {70, 130, 180, 255},   // Editable, light theme
+    {255, 223, 186, 255},  // Fixed, dark theme
+    {218, 165, 32, 255},   // Editable, dark theme
+    {255, 0, 0, 255},      // Wrong, either theme
+    {0, 0, 0, 255},        // Count, light theme
+    {0, 255, 0, 255},      // Completed count, light theme
+    {255, 255, 255, 255},  // Count, dark theme
+    {255, 0, 0, 255}       // Completed count, dark theme
+};
+static const char GLYPH_CHARS[] = "0123456789ABCDEFGHIJKLMNOP";
+static const int GLYPH_ATLAS_WIDTH = 1024;
+
+Renderer::Renderer() : window(nullptr), renderer(nullptr), font(nullptr), smallFont(nullptr), titleFont(nullptr), subtitleFont(nullptr),
+                       glyphAtlas(nullptr), glyphRects() {}
 
 Renderer::~Renderer() {
     if (cachedBackground)
@@ -51,14 +68,14 @@ bool Renderer::init() {
         return false;
     }
 
-    font = TTF_OpenFont("C:\\Windows\\Fonts\\arial.ttf", 24);
-    if (!font) {
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        TTF_Quit();
-        SDL_Quit();
+    if (!fonts.open({FONT_SIZE, SMALL_FONT_SIZE, TITLE_FONT_SIZE, SUBTITLE_FONT_SIZE})) {
+        close();
         return false;
     }
+    font = fonts.get(FONT_SIZE);
+    smallFont = fonts.get(SMALL_FONT_SIZE);
+    titleFont = fonts.get(TITLE_FONT_SIZE);
+    subtitleFont = fonts.get(SUBTITLE_FONT_SIZE);
 
     //Initialise SDL image
     if(!IMG_Init(IMG_INIT_PNG)) {
@@ -66,14 +83,102 @@ bool Renderer::init() {
         return false;
     }
 
+    if (!buildGlyphAtlas()) {
+        std::cerr << "Could not build the glyph atlas: " << SDL_GetError() << std::endl;
+        close();
+        return false;
+    }
+
     return true;
 }
 
+bool Renderer::buildGlyphAtlas() {
+    static_assert(sizeof(GLYPH_INK_COLORS) / sizeof(GLYPH_INK_COLORS[0]) == INK_COUNT, "one color per ink");
+    static_assert(sizeof(GLYPH_CHARS) - 1 == GLYPH_SYMBOLS, "one character per symbol");
+
+    // Rasterize every glyph and shelf-pack them, left to right in rows
+    std::array<SDL_Surface*, FACE_COUNT * INK_COUNT * GLYPH_SYMBOLS> glyphs{};
+    int x = 0, y = 0, rowHeight = 0;
+    bool rendered = true;
+    for (int face = 0; face < FACE_COUNT && rendered; face++) {
+        TTF_Font* faceFont = face == FACE_REGULAR || face == FACE_BOLD ? font : smallFont;
+        TTF_SetFontStyle(faceFont, face == FACE_BOLD || face == FACE_SMALL_BOLD ? TTF_STYLE_BOLD : TTF_STYLE_NORMAL);
+        for (int ink = 0; ink < INK_COUNT && rendered; ink++) {
+            for (int symbol = 0; symbol < GLYPH_SYMBOLS; symbol++) {
+                const char text[2] = {GLYPH_CHARS[symbol], '\0'};
+                int index = (face * INK_COUNT + ink) * GLYPH_SYMBOLS + symbol;
+                glyphs[index] = TTF_RenderText_Blended(faceFont, text, GLYPH_INK_COLORS[ink]);
+                if (!glyphs[index]) {
+                    rendered = false;
+                    break;
+                }
+                if (x + glyphs[index]->w > GLYPH_ATLAS_WIDTH) {
+                    x = 0;
+                    y += rowHeight;
+                    rowHeight = 0;
+                }
+                glyphRects[index] = {x, y, glyphs[index]->w, glyphs[index]->h};
+                x += glyphs[index]->w;
+                rowHeight = std::max(rowHeight, glyphs[index]->h);
+            }
+        }
+        TTF_SetFontStyle(faceFont, TTF_STYLE_NORMAL);
+    }
+
+    // Copy them into one surface, alpha included, and upload that once
+    SDL_Surface* atlas = rendered
+        ? SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, y + rowHeight, 32, SDL_PIXELFORMAT_ARGB8888)
+        : nullptr;
+    for (std::size_t i = 0; i < glyphs.size(); i++) {
+        if (!glyphs[i]) continue;
+        if (atlas) {
+            SDL_Rect destRect = glyphRects[i];  // Blitting writes back the clipped rect
+            SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphs[i], nullptr, atlas, &destRect);
+        }
+        SDL_FreeSurface(glyphs[i]);
+    }
+    if (!atlas) return false;
+
+    glyphAtlas = SDL_CreateTextureFromSurface(renderer, atlas);
+    SDL_FreeSurface(atlas);
+    if (!glyphAtlas) return false;
+    SDL_SetTextureBlendMode(glyphAtlas, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+const SDL_Rect* Renderer::glyphRect(GlyphFace face, GlyphInk ink, char symbol) const {
+    int index;
+    if (symbol >= '0' && symbol <= '9') {
+        index = symbol - '0';
+    } else if (symbol >= 'A' && symbol < 'A' + GLYPH_SYMBOLS - 10) {
+        index = 10 + symbol - 'A';
+    } else {
+        return nullptr;
+    }
+    return &glyphRects[(face * INK_COUNT + ink) * GLYPH_SYMBOLS + index];
+}
+
+int Renderer::renderGlyphs(const std::string& text, int x, int y, GlyphFace face, GlyphInk ink, int divisor) {
+    int startX = x;
+    for (char symbol : text) {
+        const SDL_Rect* source = glyphRect(face, ink, symbol);
+        if (!source) continue;
+        SDL_Rect destRect = {x, y, source->w / divisor, source->h / divisor};
+        SDL_RenderCopy(renderer, glyphAtlas, source, &destRect);
+        x += destRect.w;
+    }
+    return x - startX;
+}
+
 void Renderer::close() {
-    if (font) {
-        TTF_CloseFont(font);
-        font = nullptr;
+    textCache.clear();  // Its textures go with the renderer
+    if (glyphAtlas) {
+        SDL_DestroyTexture(glyphAtlas);
+        glyphAtlas = nullptr;
     }
+    fonts.close();
+    font = smallFont = titleFont = subtitleFont = nullptr;
     if (renderer) {
         SDL_DestroyRenderer(renderer);
         renderer = nullptr;
@@ -87,7 +192,8 @@ void Renderer::close() {
     SDL_Quit();
 }
 
-void Renderer::render(const Sudoku& sudoku, int selectedRow, int selectedCol) {
+template <int Box>
+void Renderer::render(const BasicSudoku<Box>& sudoku, int selectedRow, int selectedCol, const BasicHint<Box>* hint) {
 
     // Set background color based on theme
     SDL_SetRenderDrawColor(renderer, 
@@ -121,9 +227,12 @@ void Renderer::render(const Sudoku& sudoku, int selectedRow, int selectedCol) {
     if (selectedRow == -1 && selectedCol == -1) {
         renderHighlightedNumbers(sudoku, sudoku.getHighlightedNumber());
     } else if (selectedRow >= 0 && selectedCol >= 0) {
-        renderSelectedCell(selectedRow, selectedCol);
+        renderSelectedCell(selectedRow, selectedCol, Box);
+    }
+    if (hint) {
+        renderHint(*hint);
     }
-    renderGrid();
+    renderGrid(Box);
     renderNumbers(sudoku);
     renderNumberCounts(sudoku);
 
@@ -192,23 +301,27 @@ bool Renderer::handleResetButtonClick(int x, int y) {
 }
 
 void Renderer::renderText(const std::string& text, int x, int y, SDL_Color color) {
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!surface) return;
+    renderText(font, text, x, y, color);
+}
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) return;
+void Renderer::renderText(TTF_Font* textFont, const std::string& text, int x, int y, SDL_Color color) {
+    const TextCache::Entry* entry = textCache.get(renderer, textFont, text, color);
+    if (!entry) return;
 
-    SDL_Rect destRect;
-    TTF_SizeText(font, text.c_str(), &destRect.w, &destRect.h);
-    destRect.x = x;
-    destRect.y = y;
+    SDL_Rect destRect = {x, y, entry->width, entry->height};
+    SDL_RenderCopy(renderer, entry->texture, NULL, &destRect);
+}
+
+SDL_Point Renderer::textSize(TTF_Font* textFont, const std::string& text, SDL_Color color) {
+    const TextCache::Entry* entry = textCache.get(renderer, textFont, text, color);
+    return entry ? SDL_Point{entry->width, entry->height} : SDL_Point{0, 0};
+}
 
-    SDL_RenderCopy(renderer, texture, NULL, &destRect);
-    SDL_DestroyTexture(texture);
+std::string Renderer::symbolText(int number) {
+    return number <= 9 ? std::to_string(number) : std::string(1, static_cast<char>('A' + number - 10));
 }
 
-void Renderer::renderGrid() {
+void Renderer::renderGrid(int boxSize) {
     SDL_SetRenderDrawColor(renderer,
         currentTheme == Theme::Light ? 0 : 255,
         currentTheme == Theme::Light ? 0 : 255,
@@ -216,41 +329,45 @@ void Renderer::renderGrid() {
     // Move grid down by 50 pixels to accommodate score display
     const int GRID_START_Y = 50;
 
-    // Calculate exact grid size (9 cells)
-    const int GRID_PIXELS = Sudoku::GRID_SIZE * CELL_SIZE;
+    // Calculate exact grid size; cells shrink so any board fits the same area
+    const int gridSize = boxSize * boxSize;
+    const int cell = cellSize(gridSize);
+    const int gridPixels = gridSize * cell;
 
     // Draw horizontal lines
-    for (int i = 0; i <= Sudoku::GRID_SIZE; i++) {
-        int lineWidth = (i % 3 == 0) ? 2 : 1;
-        SDL_Rect rect = {0, GRID_START_Y + i * CELL_SIZE - lineWidth/2, GRID_PIXELS, lineWidth};
+    for (int i = 0; i <= gridSize; i++) {
+        int lineWidth = (i % boxSize == 0) ? 2 : 1;
+        SDL_Rect rect = {0, GRID_START_Y + i * cell - lineWidth/2, gridPixels, lineWidth};
         SDL_RenderFillRect(renderer, &rect);
     }
 
     // Draw vertical lines
-    for (int i = 0; i <= Sudoku::GRID_SIZE; i++) {
-        int lineWidth = (i % 3 == 0) ? 2 : 1;
-        SDL_Rect rect = {i * CELL_SIZE - lineWidth/2, GRID_START_Y, lineWidth, GRID_PIXELS};
+    for (int i = 0; i <= gridSize; i++) {
+        int lineWidth = (i % boxSize == 0) ? 2 : 1;
+        SDL_Rect rect = {i * cell - lineWidth/2, GRID_START_Y, lineWidth, gridPixels};
         SDL_RenderFillRect(renderer, &rect);
     }
 }
 
-void Renderer::renderHighlightedNumbers(const Sudoku& sudoku, int highlightedNumber) {
+template <int Box>
+void Renderer::renderHighlightedNumbers(const BasicSudoku<Box>& sudoku, int highlightedNumber) {
     if (highlightedNumber <= 0 || !sudoku.isHighlightVisible()) return;
     
     const int GRID_START_Y = 50;
+    const int cell = cellSize(BasicSudoku<Box>::GRID_SIZE);
     SDL_Color highlightColor = currentTheme == Theme::Light 
         ? SDL_Color{220, 230, 240, 255}  // Soft blue highlight for light theme
         : SDL_Color{101, 84, 43, 255};   // Dark golden brown for dark theme
 
-    for (int row = 0; row < Sudoku::GRID_SIZE; row++) {
-        for (int col = 0; col < Sudoku::GRID_SIZE; col++) {
+    for (int row = 0; row < BasicSudoku<Box>::GRID_SIZE; row++) {
+        for (int col = 0; col < BasicSudoku<Box>::GRID_SIZE; col++) {
             if (sudoku.getNumber(row, col) == highlightedNumber) {
                 SDL_SetRenderDrawColor(renderer, highlightColor.r, highlightColor.g, highlightColor.b, highlightColor.a);
                 SDL_Rect cellRect = {
-                    col * CELL_SIZE,
-                    GRID_START_Y + row * CELL_SIZE,
-                    CELL_SIZE,
-                    CELL_SIZE
+                    col * cell,
+                    GRID_START_Y + row * cell,
+                    cell,
+                    cell
                 };
                 SDL_RenderFillRect(renderer, &cellRect);
             }
@@ -258,9 +375,44 @@ void Renderer::renderHighlightedNumbers(const Sudoku& sudoku, int highlightedNum
     }
 }
 
-void Renderer::renderNumbers(const Sudoku& sudoku) {
-    for (int row = 0; row < Sudoku::GRID_SIZE; row++) {
-        for (int col = 0; col < Sudoku::GRID_SIZE; col++) {
+template <int Box>
+void Renderer::renderHint(const BasicHint<Box>& hint) {
+    const int GRID_START_Y = 50;
+    const int GRID_SIZE = BasicBoard<Box>::SIZE;
+    const int cell = cellSize(GRID_SIZE);
+
+    SDL_Color supportColor, targetColor;
+    if (currentTheme == Theme::Light) {
+        supportColor = {225, 245, 225, 255};  // Pale green
+        targetColor = hint.mistake ? SDL_Color{250, 200, 200, 255} : SDL_Color{160, 220, 160, 255};
+    } else {
+        supportColor = {40, 80, 40, 255};     // Deep green
+        targetColor = hint.mistake ? SDL_Color{120, 30, 30, 255} : SDL_Color{60, 130, 60, 255};
+    }
+
+    // Cells the deduction rests on, then the cell it is about
+    SDL_SetRenderDrawColor(renderer, supportColor.r, supportColor.g, supportColor.b, supportColor.a);
+    for (int index = 0; index < BasicBoard<Box>::CELLS; index++) {
+        if (!hint.support.test(index)) continue;
+        SDL_Rect supportRect = {(index % GRID_SIZE) * cell, GRID_START_Y + (index / GRID_SIZE) * cell, cell, cell};
+        SDL_RenderFillRect(renderer, &supportRect);
+    }
+    SDL_SetRenderDrawColor(renderer, targetColor.r, targetColor.g, targetColor.b, targetColor.a);
+    SDL_Rect targetRect = {hint.col * cell, GRID_START_Y + hint.row * cell, cell, cell};
+    SDL_RenderFillRect(renderer, &targetRect);
+
+    // Name the technique between the score and the reset button
+    std::string text = hint.mistake ? "Mistake"
+        : std::string(BasicLogicalSolver<Box>::techniqueName(hint.technique)) + ": " + symbolText(hint.digit);
+    SDL_Color textColor = currentTheme == Theme::Light ? SDL_Color{0, 0, 0, 255} : SDL_Color{255, 255, 255, 255};
+    SDL_Point size = textSize(smallFont, text, textColor);
+    renderText(smallFont, text, 130, 25 - size.y / 2, textColor);
+}
+
+template <int Box>
+void Renderer::renderNumbers(const BasicSudoku<Box>& sudoku) {
+    for (int row = 0; row < BasicSudoku<Box>::GRID_SIZE; row++) {
+        for (int col = 0; col < BasicSudoku<Box>::GRID_SIZE; col++) {
             int number = sudoku.getNumber(row, col);
             if (number != 0) {
                 renderNumber(number, row, col, !sudoku.isCellEditable(row, col), sudoku);
@@ -269,9 +421,10 @@ void Renderer::renderNumbers(const Sudoku& sudoku) {
     }
 }
 
-void Renderer::renderSelectedCell(int row, int col) {
+void Renderer::renderSelectedCell(int row, int col, int boxSize) {
     // Calculate exact grid size
-    const int GRID_PIXELS = Sudoku::GRID_SIZE * CELL_SIZE;
+    const int cell = cellSize(boxSize * boxSize);
+    const int gridPixels = boxSize * boxSize * cell;
     const int GRID_START_Y = 50;
 
     // Define colors based on theme
@@ -290,144 +443,91 @@ void Renderer::renderSelectedCell(int row, int col) {
 
     // Render row, column, and subgrid highlights first
     SDL_SetRenderDrawColor(renderer, rowColor.r, rowColor.g, rowColor.b, rowColor.a);
-    SDL_Rect rowRect = {0, GRID_START_Y + row * CELL_SIZE, GRID_PIXELS, CELL_SIZE};
+    SDL_Rect rowRect = {0, GRID_START_Y + row * cell, gridPixels, cell};
     SDL_RenderFillRect(renderer, &rowRect);
 
     SDL_SetRenderDrawColor(renderer, colColor.r, colColor.g, colColor.b, colColor.a);
-    SDL_Rect colRect = {col * CELL_SIZE, GRID_START_Y, CELL_SIZE, GRID_PIXELS};
+    SDL_Rect colRect = {col * cell, GRID_START_Y, cell, gridPixels};
     SDL_RenderFillRect(renderer, &colRect);
 
     SDL_SetRenderDrawColor(renderer, subgridColor.r, subgridColor.g, subgridColor.b, subgridColor.a);
-    int subgridStartRow = (row / 3) * 3;
-    int subgridStartCol = (col / 3) * 3;
-    SDL_Rect subgridRect = {subgridStartCol * CELL_SIZE, GRID_START_Y + subgridStartRow * CELL_SIZE, CELL_SIZE * 3, CELL_SIZE * 3};
+    int subgridStartRow = (row / boxSize) * boxSize;
+    int subgridStartCol = (col / boxSize) * boxSize;
+    SDL_Rect subgridRect = {subgridStartCol * cell, GRID_START_Y + subgridStartRow * cell, cell * boxSize, cell * boxSize};
     SDL_RenderFillRect(renderer, &subgridRect);
 
     // Render the selected cell on top with yellow highlight
     SDL_SetRenderDrawColor(renderer, selectedColor.r, selectedColor.g, selectedColor.b, selectedColor.a);
-    SDL_Rect selectedRect = {col * CELL_SIZE, GRID_START_Y + row * CELL_SIZE, CELL_SIZE, CELL_SIZE};
+    SDL_Rect selectedRect = {col * cell, GRID_START_Y + row * cell, cell, cell};
     SDL_RenderFillRect(renderer, &selectedRect);
 }
 
-std::array<int, 9> Renderer::calculateNumberCounts(const Sudoku& sudoku) const {
-    std::array<int, 9> counts {0};  // Zero-initialize array
-    for (int row = 0; row < Sudoku::GRID_SIZE; row++) {
-        for (int col = 0; col < Sudoku::GRID_SIZE; col++) {
-            int num = sudoku.getNumber(row, col);
-            if (num > 0) {
-                counts[num - 1]++;
-            }
-        }
-    }
-    return counts;
-}
-
-void Renderer::renderNumberCounts(const Sudoku& sudoku) {
-    auto counts = calculateNumberCounts(sudoku);
+template <int Box>
+void Renderer::renderNumberCounts(const BasicSudoku<Box>& sudoku) {
+    const int GRID_SIZE = BasicSudoku<Box>::GRID_SIZE;
     
-    int numberWidth = CELL_SIZE / 2;
+    int numberWidth = std::min(CELL_SIZE / 2, WINDOW_WIDTH / (GRID_SIZE + 1));
     // Calculate padding to span the entire width
     int totalWidth = WINDOW_WIDTH;
-    int padding = (totalWidth - (9 * numberWidth)) / 10;  // 10 spaces (9 numbers + 1)
+    int padding = (totalWidth - (GRID_SIZE * numberWidth)) / (GRID_SIZE + 1);  // One space per symbol, plus one
     int startX = padding;  // Start after first padding
     int startY = WINDOW_HEIGHT - 40;  // Position for number counts (moved down 4 pixels)
     
-    for (int i = 0; i < 9; i++) {
-        SDL_Color color;
+    for (int i = 0; i < GRID_SIZE; i++) {
+        int count = sudoku.getDigitCount(i + 1);
+        GlyphInk ink;
         if (currentTheme == Theme::Light) {
-            color = (counts[i] == 9) ? SDL_Color{0, 255, 0, 255} : SDL_Color{0, 0, 0, 255};
+            ink = (count == GRID_SIZE) ? INK_COUNT_DONE_LIGHT : INK_COUNT_LIGHT;
         } else {
-            color = (counts[i] == 9) ? SDL_Color{255, 0, 0, 255} : SDL_Color{255, 255, 255, 255};
-        }
-        
-        // Render the number
-        TTF_SetFontStyle(font, TTF_STYLE_BOLD);
-        std::string numStr = std::to_string(i + 1);
-        SDL_Surface* numSurface = TTF_RenderText_Blended(font, numStr.c_str(), color);
-        if (!numSurface) continue;
-        
-        SDL_Texture* numTexture = SDL_CreateTextureFromSurface(renderer, numSurface);
-        if (!numTexture) {
-            SDL_FreeSurface(numSurface);
-            continue;
+            ink = (count == GRID_SIZE) ? INK_COUNT_DONE_DARK : INK_COUNT_DARK;
         }
         
-        // Position each number with uniform padding
-        SDL_Rect numRect = {startX + i * (numberWidth + padding), startY, numSurface->w, numSurface->h};
-        SDL_RenderCopy(renderer, numTexture, nullptr, &numRect);
+        // Render the number in bold, positioned with uniform padding
+        int numX = startX + i * (numberWidth + padding);
+        int numWidth = renderGlyphs(symbolText(i + 1), numX, startY, boardFace(GRID_SIZE, true), ink);
         
-        // Render the count as superscript if not complete
-        if (counts[i] < 9) {
-            TTF_SetFontStyle(font, TTF_STYLE_NORMAL);  // Use normal style for count
-            std::string countStr = std::to_string(counts[i]);
-            SDL_Surface* countSurface = TTF_RenderText_Blended(font, countStr.c_str(), color);
-            if (countSurface) {
-                SDL_Texture* countTexture = SDL_CreateTextureFromSurface(renderer, countSurface);
-                if (countTexture) {
-                    SDL_Rect countRect = {
-                        startX + i * (numberWidth + padding) + numSurface->w, // Match the number's padding
-                        startY - 5,  // Keep the vertical offset
-                        countSurface->w / 2, 
-                        countSurface->h / 2
-                    };
-                    SDL_RenderCopy(renderer, countTexture, nullptr, &countRect);
-                    SDL_DestroyTexture(countTexture);
-                }
-                SDL_FreeSurface(countSurface);
-            }
+        // Render the count as a half-size superscript if not complete
+        if (count < GRID_SIZE) {
+            renderGlyphs(std::to_string(count), numX + numWidth, startY - 5, boardFace(GRID_SIZE, false), ink, 2);
         }
-        
-        SDL_FreeSurface(numSurface);
-        SDL_DestroyTexture(numTexture);
     }
-    
-    // Reset font style to normal at the end
-    TTF_SetFontStyle(font, TTF_STYLE_NORMAL);
 }
 
-void Renderer::renderNumber(int number, int row, int col, bool isFixed, const Sudoku& sudoku) {
-    SDL_Color color;
+template <int Box>
+void Renderer::renderNumber(int number, int row, int col, bool isFixed, const BasicSudoku<Box>& sudoku) {
     if (number == 0) return;
     
-    // Check if number is valid without modifying the grid
-    bool isWrong = !isFixed && number != 0 && !sudoku.isValid(row, col, number);
+    // Player digits that clash with another digit in a row, column or box
+    bool isWrong = !isFixed && sudoku.hasConflict(row, col);
 
-    // Set color based on number state and theme
+    // Pick the ink based on number state and theme
+    GlyphInk ink;
     if (isWrong)
     {
-        color = SDL_Color{255, 0, 0, 255}; // Red color for wrong numbers
+        ink = INK_WRONG;
     }
     else if (currentTheme == Theme::Light)
     {
-        color = isFixed ? SDL_Color{47, 79, 79, 255} : SDL_Color{70, 130, 180, 255};
+        ink = isFixed ? INK_FIXED_LIGHT : INK_EDITABLE_LIGHT;
     }
     else
     {
-        color = isFixed ? SDL_Color{255, 223, 186, 255} : SDL_Color{218, 165, 32, 255};
+        ink = isFixed ? INK_FIXED_DARK : INK_EDITABLE_DARK;
     }
 
-    std::string text = std::to_string(number);
     const int GRID_START_Y = 50;
-    
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!surface) return;
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) return;
-
-    int textW, textH;
-    SDL_QueryTexture(texture, nullptr, nullptr, &textW, &textH);
+    const int cell = cellSize(BasicSudoku<Box>::GRID_SIZE);
+    const SDL_Rect* source = glyphRect(boardFace(BasicSudoku<Box>::GRID_SIZE, false), ink, symbolText(number)[0]);
+    if (!source) return;
 
     SDL_Rect dstRect = {
-        col * CELL_SIZE + (CELL_SIZE - textW) / 2,
-        GRID_START_Y + row * CELL_SIZE + (CELL_SIZE - textH) / 2,
-        textW,
-        textH
+        col * cell + (cell - source->w) / 2,
+        GRID_START_Y + row * cell + (cell - source->h) / 2,
+        source->w,
+        source->h
     };
 
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-    SDL_DestroyTexture(texture);
+    SDL_RenderCopy(renderer, glyphAtlas, source, &dstRect);
 }
 
 void Renderer::renderMessage(const std::string& message) {
@@ -439,22 +539,8 @@ void Renderer::renderMessage(const std::string& message) {
         textColor = SDL_Color{255, 223, 186, 255};  // Light peach for dark theme
     }
 
-    SDL_Surface* surface = TTF_RenderText_Blended(font, message.c_str(), textColor);
-    if (!surface) return;
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) return;
-
-    int textW, textH;
-    SDL_QueryTexture(texture, nullptr, nullptr, &textW, &textH);
-
-    SDL_Rect dstRect = {
-        (WINDOW_WIDTH - textW) / 2,
-        WINDOW_HEIGHT / 2 - textH / 2,
-        textW,
-        textH
-    };
+    SDL_Point size = textSize(font, message, textColor);
+    if (size.x == 0) return;
 
     // Draw semi-transparent background based on theme
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
@@ -467,11 +553,25 @@ void Renderer::renderMessage(const std::string& message) {
     SDL_RenderFillRect(renderer, &bgRect);
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-    SDL_DestroyTexture(texture);
+    renderText(message, (WINDOW_WIDTH - size.x) / 2, WINDOW_HEIGHT / 2 - size.y / 2, textColor);
     SDL_RenderPresent(renderer);
 }
 
+void Renderer::renderWaitScreen(const std::string& message) {
+    SDL_SetRenderDrawColor(renderer,
+        currentTheme == Theme::Light ? 255 : 0,
+        currentTheme == Theme::Light ? 255 : 0,
+        currentTheme == Theme::Light ? 255 : 0, 255);
+    SDL_RenderClear(renderer);
+
+    // renderMessage presents the frame, so the note goes in first
+    SDL_Color noteColor = currentTheme == Theme::Light ? SDL_Color{105, 105, 105, 255} : SDL_Color{190, 190, 190, 255};
+    const std::string note = "Press Esc to return to the menu";
+    SDL_Point size = textSize(smallFont, note, noteColor);
+    renderText(smallFont, note, (WINDOW_WIDTH - size.x) / 2, WINDOW_HEIGHT / 2 + 40, noteColor);
+    renderMessage(message);
+}
+
 void Renderer::renderHighGammaEffect() {
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 180);
@@ -504,47 +604,19 @@ void Renderer::renderMenuScreen() {
         sliderInitialized = true;
     }
 
-    // Set font style and size for the title
-    TTF_Font* titleFont = TTF_OpenFont("C:\\Windows\\Fonts\\arial.ttf", 72);
+    // Render SUDOKU title with the large bold font
     TTF_SetFontStyle(titleFont, TTF_STYLE_BOLD);
     SDL_Color titleColor = currentTheme == Theme::Light ? SDL_Color{0, 0, 0, 255} : SDL_Color{255, 255, 255, 255};
-    
-    // Render SUDOKU title with larger font
-    SDL_Surface* surface = TTF_RenderText_Blended(titleFont, "SUDOKU", titleColor);
-    if (surface) {
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (texture) {
-            SDL_Rect destRect;
-            TTF_SizeText(titleFont, "SUDOKU", &destRect.w, &destRect.h);
-            destRect.x = WINDOW_WIDTH / 2 - destRect.w / 2;
-            destRect.y = WINDOW_HEIGHT / 4 - destRect.h / 2;  // Moved up to 1/4 of screen
-            SDL_RenderCopy(renderer, texture, NULL, &destRect);
-            SDL_DestroyTexture(texture);
-        }
-        SDL_FreeSurface(surface);
-    }
-    TTF_CloseFont(titleFont);
+    SDL_Point titleSize = textSize(titleFont, "SUDOKU", titleColor);
+    renderText(titleFont, "SUDOKU", WINDOW_WIDTH / 2 - titleSize.x / 2,
+               WINDOW_HEIGHT / 4 - titleSize.y / 2, titleColor);  // Moved up to 1/4 of screen
 
-    // Set font style and size for the subtitle
-    TTF_Font* subtitleFont = TTF_OpenFont("C:\\Windows\\Fonts\\arial.ttf", 16);
+    // Render subtitle with the small italic font
     TTF_SetFontStyle(subtitleFont, TTF_STYLE_ITALIC);
     SDL_Color subtitleColor = currentTheme == Theme::Light ? SDL_Color{128, 128, 128, 255} : SDL_Color{200, 200, 200, 255};
-    
-    // Render subtitle with smaller font
-    surface = TTF_RenderText_Blended(subtitleFont, "Made by Nsubuga Benard", subtitleColor);
-    if (surface) {
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (texture) {
-            SDL_Rect destRect;
-            TTF_SizeText(subtitleFont, "Made by Nsubuga Benard", &destRect.w, &destRect.h);
-            destRect.x = WINDOW_WIDTH / 2 - destRect.w / 2;
-            destRect.y = WINDOW_HEIGHT / 4 + 60;
-            SDL_RenderCopy(renderer, texture, NULL, &destRect);
-            SDL_DestroyTexture(texture);
-        }
-        SDL_FreeSurface(surface);
-    }
-    TTF_CloseFont(subtitleFont);
+    SDL_Point subtitleSize = textSize(subtitleFont, "Made by Nsubuga Benard", subtitleColor);
+    renderText(subtitleFont, "Made by Nsubuga Benard", WINDOW_WIDTH / 2 - subtitleSize.x / 2,
+               WINDOW_HEIGHT / 4 + 60, subtitleColor);
 
     // Reset font style for the buttons
     TTF_SetFontStyle(font, TTF_STYLE_NORMAL);
@@ -556,6 +628,14 @@ void Renderer::renderMenuScreen() {
     // Render the difficulty slider
     renderDifficultySlider();
  
+    // Board size button, above the theme button
+    SDL_Rect sizeBtn = {
+        WINDOW_WIDTH / 2 - buttonWidth / 2,
+        startY - buttonSpacing,
+        buttonWidth,
+        buttonHeight
+    };
+
     // Theme button
     SDL_Rect themeBtn = {
         WINDOW_WIDTH / 2 - buttonWidth / 2,
@@ -575,6 +655,12 @@ void Renderer::renderMenuScreen() {
     // Get mouse state for hover effects
     Uint32 mouseState = SDL_GetMouseState(&mouseX, &mouseY);
 
+    // Render board size button
+    int gridSize = DifficultySettings::getBoxSize() * DifficultySettings::getBoxSize();
+    renderMenuButton(sizeBtn,
+                    "Board: " + std::to_string(gridSize) + "x" + std::to_string(gridSize),
+                    mouseX, mouseY, mouseState, false);
+
     // Render theme button
     renderMenuButton(themeBtn, 
                     "Switch Theme",
@@ -664,13 +750,11 @@ void Renderer::renderMenuButton(const SDL_Rect& btn, const std::string& text, in
     SDL_RenderDrawRect(renderer, &buttonRect);
 
     // Calculate text position to center it in the button
-    int textWidth, textHeight;
-    TTF_SizeText(font, text.c_str(), &textWidth, &textHeight);
-    
     SDL_Color textColor = {255, 255, 255, 255};
+    SDL_Point size = textSize(font, text, textColor);
     renderText(text,
-        buttonRect.x + (buttonRect.w - textWidth) / 2 + (isHovered ? (isClicked ? 2 : 1) : 0),
-        buttonRect.y + (buttonRect.h - textHeight) / 2 + (isHovered ? (isClicked ? 2 : 1) : 0),
+        buttonRect.x + (buttonRect.w - size.x) / 2 + (isHovered ? (isClicked ? 2 : 1) : 0),
+        buttonRect.y + (buttonRect.h - size.y) / 2 + (isHovered ? (isClicked ? 2 : 1) : 0),
         textColor);
 }
 
@@ -681,6 +765,13 @@ bool Renderer::handleMenuClick(int x, int y) {
     const int buttonSpacing = buttonHeight * 1.5;
     const int startY = WINDOW_HEIGHT / 2;
 
+    // Board size button
+    SDL_Rect sizeBtn = {
+        WINDOW_WIDTH / 2 - buttonWidth / 2,
+        startY - buttonSpacing,
+        buttonWidth,
+        buttonHeight};
+
     // Theme button
     SDL_Rect themeBtn = {
         WINDOW_WIDTH / 2 - buttonWidth / 2,
@@ -695,6 +786,15 @@ bool Renderer::handleMenuClick(int x, int y) {
         buttonWidth,
         buttonHeight};
 
+    // Check if board size button was clicked: cycles 4x4, 9x9, 16x16, 25x25
+    if (x >= sizeBtn.x && x <= sizeBtn.x + sizeBtn.w &&
+        y >= sizeBtn.y && y <= sizeBtn.y + sizeBtn.h)
+    {
+        int boxSize = DifficultySettings::getBoxSize();
+        DifficultySettings::setBoxSize(boxSize >= 5 ? 2 : boxSize + 1);
+        return false;
+    }
+
     // Check if theme button was clicked
     if (x >= themeBtn.x && x <= themeBtn.x + themeBtn.w &&
         y >= themeBtn.y && y <= themeBtn.y + themeBtn.h)
@@ -754,23 +854,19 @@ void Renderer::renderVictoryScreen(int score, int elapsedSeconds) {
     // Score
     renderText("Score:", labelX, yPos, textColor);
     std::string scoreStr = std::to_string(score);
-    int textW, textH;
-    TTF_SizeText(font, scoreStr.c_str(), &textW, &textH);
-    renderText(scoreStr, valueX - textW, yPos, textColor);
+    renderText(scoreStr, valueX - textSize(font, scoreStr, textColor).x, yPos, textColor);
     yPos += 30;
     // Time
     renderText("Time:", labelX, yPos, textColor);
     std::stringstream timeStr;
     timeStr << elapsedSeconds / 60 << ":" << std::setfill('0') << std::setw(2) << elapsedSeconds % 60;
-    TTF_SizeText(font, timeStr.str().c_str(), &textW, &textH);
-    renderText(timeStr.str(), valueX - textW, yPos, textColor);
+    renderText(timeStr.str(), valueX - textSize(font, timeStr.str(), textColor).x, yPos, textColor);
     yPos += 30;
     // Accuracy
     renderText("Accuracy:", labelX, yPos, textColor);
     std::stringstream accuracyStr;
     accuracyStr << std::fixed << std::setprecision(1) << accuracy << "%";
-    TTF_SizeText(font, accuracyStr.str().c_str(), &textW, &textH);
-    renderText(accuracyStr.str(), valueX - textW, yPos, textColor);
+    renderText(accuracyStr.str(), valueX - textSize(font, accuracyStr.str(), textColor).x, yPos, textColor);
     yPos += 30;
     // Render buttons with enhanced visual effects
     SDL_Rect newGameBtn = {WINDOW_WIDTH / 2 - 100, yPos + 20, 200, 40};
@@ -838,11 +934,10 @@ void Renderer::renderVictoryScreen(int score, int elapsedSeconds) {
     // Button text
     SDL_Color white = {255, 255, 255, 255};
     // Calculate text dimensions for centering
-    int textWidth, textHeight;
-    TTF_SizeText(font, buttonText, &textWidth, &textHeight);
+    SDL_Point textDims = textSize(font, buttonText, white);
     // Center text horizontally and vertically within the button
-    int textX = buttonRect.x + (buttonRect.w - textWidth) / 2 + (isHovered ? (isCurrentlyClicked ? 3 : 1) : 0);
-    int textY = buttonRect.y + (buttonRect.h - textHeight) / 2 + (isHovered ? (isCurrentlyClicked ? 3 : 1) : 0);
+    int textX = buttonRect.x + (buttonRect.w - textDims.x) / 2 + (isHovered ? (isCurrentlyClicked ? 3 : 1) : 0);
+    int textY = buttonRect.y + (buttonRect.h - textDims.y) / 2 + (isHovered ? (isCurrentlyClicked ? 3 : 1) : 0);
     renderText(buttonText, textX, textY, white);
     }
     SDL_RenderPresent(renderer);
@@ -859,19 +954,24 @@ int Renderer::handleVictoryScreenClick(int x, int y) {
         } else if (y >= mainMenuBtn.y && y <= mainMenuBtn.y + mainMenuBtn.h) {
             return 2;  // Main Menu clicked
         } else if (y >= exitBtn.y && y <= exitBtn.y + exitBtn.h) {
-            SDL_Quit();
-            exit(0);
+            return 3;  // Exit clicked; the game shuts down like on SDL_QUIT
         }
     }
-    return false;
+    return 0;
 }
-void Renderer::getGridPosition(int mouseX, int mouseY, int& row, int& col) {
+void Renderer::getGridPosition(int mouseX, int mouseY, int gridSize, int& row, int& col) {
     const int GRID_START_Y = 50;
-    row = (mouseY - GRID_START_Y) / CELL_SIZE;
-    col = mouseX / CELL_SIZE;
+    const int cell = cellSize(gridSize);
+    row = (mouseY - GRID_START_Y) / cell;
+    col = mouseX / cell;
     
     if (row < 0) row = 0;
-    if (row >= Sudoku::GRID_SIZE) row = Sudoku::GRID_SIZE - 1;
+    if (row >= gridSize) row = gridSize - 1;
     if (col < 0) col = 0;
-    if (col >= Sudoku::GRID_SIZE) col = Sudoku::GRID_SIZE - 1;
-}
\ No newline at end of file
+    if (col >= gridSize) col = gridSize - 1;
+}
+
+template void Renderer::render<2>(const BasicSudoku<2>&, int, int, const BasicHint<2>*);
+template void Renderer::render<3>(const BasicSudoku<3>&, int, int, const BasicHint<3>*);
+template void Renderer::render<4>(const BasicSudoku<4>&, int, int, const BasicHint<4>*);
+template void Renderer::render<5>(const BasicSudoku<5>&, int, int, const BasicHint<5>*);
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "solver.h"
+#include "dlx_solver.h"
+#include "generation_stats.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+SolverBackend Solver::backend = SolverBackend::Backtracking;
+
+bool Solver::parseBackend(const std::string& name, SolverBackend& result) {
+    if (name == "backtracking") {
+        result = SolverBackend::Backtracking;
+    } else if (name == "dlx") {
+        result = SolverBackend::DancingLinks;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* Solver::backendName(SolverBackend backend) {
+    return backend == SolverBackend::DancingLinks ? "dlx" : "backtracking";
+}
+
+template <int Box>
+int Solver::countSolutions(const BasicBoard<Box>& board, int limit, BasicBoard<Box>* solution) {
+    SUDOKU_STAT_ADD(solutionCounts, 1);
+    if (backend == SolverBackend::DancingLinks) {
+        BasicDlxSolver<Box> dlx(board);
+        return dlx.countSolutions(limit, solution);
+    }
+    BasicBoard<Box> work = board;
+    return countBacktracking(work, limit, 0, solution);
+}
+
+template <int Box>
+bool Solver::solve(BasicBoard<Box>& board) {
+    return countSolutions(board, 1, &board) == 1;
+}
+
+template <int Box>
+bool Solver::hasAlternative(const BasicBoard<Box>& board, int row, int col, int num) {
+    typedef BasicBoard<Box> Board;
+    // One scratch board serves every alternative digit
+    Board work = board;
+    for (typename Board::Mask others = board.candidates(row, col) & ~Board::bit(num); others; others &= others - 1) {
+        work.place(row, col, Board::lowestDigit(others));
+        bool found = countSolutions(work, 1) > 0;
+        work.remove(row, col);
+        if (found) return true;
+    }
+    return false;
+}
+
+template <int Box>
+int Solver::countBacktracking(BasicBoard<Box> board, int limit, int count, BasicBoard<Box>* solution) {
+    typedef BasicBoard<Box> Board;
+    SUDOKU_STAT_ADD(nodeVisits, 1);
+    if (!propagateSingles(board)) {
+        SUDOKU_STAT_ADD(backtracks, 1);
+        return count;  // Some cell or digit has nowhere left to go
+    }
+
+    int bestRow, bestCol;
+    if (!findBranchCell(board, bestRow, bestCol)) {
+        if (count == 0 && solution) {
+            *solution = board;
+        }
+        return count + 1;
+    }
+
+    for (typename Board::Mask candidates = board.candidates(bestRow, bestCol); candidates && count < limit; candidates &= candidates - 1) {
+        Board next = board;
+        next.place(bestRow, bestCol, Board::lowestDigit(candidates));
+        count = countBacktracking(next, limit, count, solution);
+    }
+
+    return count;
+}
+
+// Shared state of one countSolutionsParallel call
+struct Solver::ParallelCount {
+    ThreadPool& pool;
+    uint64_t limit;
+    std::atomic<uint64_t> count;
+    std::atomic<std::size_t> pending;  // Tasks submitted and not yet finished
+    std::mutex mutex;
+    std::condition_variable done;
+
+    ParallelCount(ThreadPool& pool, uint64_t limit) : pool(pool), limit(limit), count(0), pending(0) {}
+
+    bool reached(uint64_t found) const { return count.load(std::memory_order_relaxed) + found >= limit; }
+};
+
+template <int Box>
+uint64_t Solver::countSolutionsParallel(const BasicBoard<Box>& board, uint64_t limit, ThreadPool& pool) {
+    if (limit == 0) return 0;
+    ParallelCount shared(pool, limit);
+    spawnCount(shared, board, 0);
+
+    std::unique_lock<std::mutex> lock(shared.mutex);
+    shared.done.wait(lock, [&shared] { return shared.pending == 0; });
+    return std::min(shared.count.load(), limit);
+}
+
+template <int Box>
+void Solver::spawnCount(ParallelCount& shared, const BasicBoard<Box>& board, int depth) {
+    shared.pending++;
+    shared.pool.submit([&shared, board, depth] {
+        uint64_t found = 0;
+        countParallelNode(shared, board, depth, found);
+        shared.count += found;
+        // Under the lock, so the waiter cannot return and free shared before
+        // this task is done with it
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (--shared.pending == 0) {
+            shared.done.notify_all();
+        }
+    });
+}
+
+// Backtracking count of one subtree. A child is handed to the pool instead
+// of searched here while the pool's queues hold fewer tasks than it has
+// workers, so an idle worker always finds a large subtree to steal.
+template <int Box>
+void Solver::countParallelNode(ParallelCount& shared, BasicBoard<Box> board, int depth, uint64_t& found) {
+    typedef BasicBoard<Box> Board;
+    if (shared.reached(found)) return;
+    if (!propagateSingles(board)) return;
+
+    int row, col;
+    if (!findBranchCell(board, row, col)) {
+        if (++found == COUNT_BATCH) {
+            shared.count += found;
+            found = 0;
+        }
+        return;
+    }
+
+    for (typename Board::Mask candidates = board.candidates(row, col); candidates && !shared.reached(found); candidates &= candidates - 1) {
+        Board next = board;
+        next.place(row, col, Board::lowestDigit(candidates));
+        if (depth < MAX_SPLIT_DEPTH && shared.pool.queuedTasks() < shared.pool.size()) {
+            spawnCount(shared, next, depth + 1);
+        } else {
+            countParallelNode(shared, next, depth + 1, found);
+        }
+    }
+}
+
+template <int Box>
+bool Solver::findBranchCell(const BasicBoard<Box>& board, int& row, int& col) {
+    typedef BasicBoard<Box> Board;
+    // A two-candidate cell is as good as it gets once singles are propagated
+    int bestCount = Board::SIZE + 1;
+    row = -1;
+    col = -1;
+    for (int i = 0; i < Board::SIZE && bestCount > 2; i++) {
+        for (int j = 0; j < Board::SIZE; j++) {
+            if (!board.isEmpty(i, j)) continue;
+            int candidateCount = board.candidateCount(i, j);
+            if (candidateCount < bestCount) {
+                row = i;
+                col = j;
+                bestCount = candidateCount;
+                if (bestCount == 2) break;
+            }
+        }
+    }
+    return row != -1;
+}
+
+// Places naked and hidden singles until a fixpoint is reached.
+// Returns false as soon as a cell or a unit digit runs out of places.
+template <int Box>
+bool Solver::propagateSingles(BasicBoard<Box>& board) {
+    typedef BasicBoard<Box> Board;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (int row = 0; row < Board::SIZE; row++) {
+            for (int col = 0; col < Board::SIZE; col++) {
+                if (!board.isEmpty(row, col)) continue;
+                typename Board::Mask candidates = board.candidates(row, col);
+                if (candidates == 0) return false;
+                if ((candidates & (candidates - 1)) == 0) {
+                    board.place(row, col, Board::lowestDigit(candidates));
+                    changed = true;
+                }
+            }
+        }
+
+        for (int unit = 0; unit < Board::UNITS; unit++) {
+            // Digits that fit in at least one / at least two empty cells of the unit
+            typename Board::Mask once = 0, twice = 0;
+            for (int i = 0; i < Board::SIZE; i++) {
+                int cell = Board::unitCell(unit, i);
+                if (board.getCell(cell) != 0) continue;
+                typename Board::Mask candidates = board.candidates(cell / Board::SIZE, cell % Board::SIZE);
+                twice |= once & candidates;
+                once |= candidates;
+            }
+
+            typename Board::Mask placed = board.unitMask(unit);
+            if ((once | placed) != Board::ALL_DIGITS) return false;
+
+            for (typename Board::Mask hidden = once & ~twice & ~placed; hidden; hidden &= hidden - 1) {
+                int num = Board::lowestDigit(hidden);
+                for (int i = 0; i < Board::SIZE; i++) {
+                    int cell = Board::unitCell(unit, i);
+                    int row = cell / Board::SIZE, col = cell % Board::SIZE;
+                    if (board.getCell(cell) == 0 && board.canPlace(row, col, num)) {
+                        board.place(row, col, num);
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+#define SUDOKU_INSTANTIATE_SOLVER(Box) \
+    template int Solver::countSolutions<Box>(const BasicBoard<Box>&, int, BasicBoard<Box>*); \
+    template bool Solver::solve<Box>(BasicBoard<Box>&); \
+    template bool Solver::hasAlternative<Box>(const BasicBoard<Box>&, int, int, int); \
+    template uint64_t Solver::countSolutionsParallel<Box>(const BasicBoard<Box>&, uint64_t, ThreadPool&);
+
+SUDOKU_INSTANTIATE_SOLVER(2)
+SUDOKU_INSTANTIATE_SOLVER(3)
+SUDOKU_INSTANTIATE_SOLVER(4)
+SUDOKU_INSTANTIATE_SOLVER(5)
@@ -1,360 +1,458 @@
 #include "sudoku.h"
-#include "difficulty_settings.h"
-#include <ctime>
-
-Sudoku::Sudoku() : grid(GRID_SIZE, std::vector<int>(GRID_SIZE, 0)),
-           solution(GRID_SIZE, std::vector<int>(GRID_SIZE, 0)),
-           fixed(GRID_SIZE, std::vector<bool>(GRID_SIZE, false)),
-           scored(GRID_SIZE, std::vector<bool>(GRID_SIZE, false)),
-           wrong_answers(GRID_SIZE, std::vector<int>(GRID_SIZE, 0)),
+#include "solver.h"
+#include "grid_synthesizer.h"
+#include "canonical_form.h"
+#include "puzzle_index.h"
+#include "logical_solver.h"
+#include "byte_order.h"
+#include <type_traits>
+#include <random>
+#include <numeric>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static_assert(std::is_trivially_copyable<Sudoku>::value,
+              "Sudoku must stay memcpy-able for snapshots and undo");
+
+template <int Box>
+BasicSudoku<Box>::BasicSudoku() :
+           grid{},
+           solution{},
+           wrong_answers{},
+           difficulty(0.5f),
+           rating(0.0f),
+           puzzleId(0),
            score(0),
+           correctInputs(0),
+           totalAttempts(0),
            highlightedNumber(0),
-           highlightedVisible(false) {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
-    generatePuzzle();
-    initializeScore();
+           highlightedVisible(false),
+           rowMask{}, colMask{}, boxMask{},
+           rowDupMask{}, colDupMask{}, boxDupMask{},
+           rowCorrect{}, colCorrect{}, boxCorrect{},
+           digitCount{},
+           filledCount(0) {
+    SUDOKU_STAT(stats = GenerationStats{});
 }
 
-void Sudoku::generatePuzzle() {
-    // Start with an empty grid
-    for (auto& row : grid) {
-        std::fill(row.begin(), row.end(), 0);
-    }
-    for (auto& row : fixed) {
-        std::fill(row.begin(), row.end(), false);
-    }
+template <int Box>
+BasicSudoku<Box>::BasicSudoku(float difficulty) : BasicSudoku(difficulty, randomPuzzleId()) {
+}
 
-    // Fill diagonal boxes first (they are independent)
-    for (int box = 0; box < GRID_SIZE; box += SUBGRID_SIZE) {
-        std::vector<int> nums(GRID_SIZE);
-        std::iota(nums.begin(), nums.end(), 1);
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::shuffle(nums.begin(), nums.end(), gen);
-        
-        for (int i = 0; i < SUBGRID_SIZE; i++) {
-            for (int j = 0; j < SUBGRID_SIZE; j++) {
-                grid[box + i][box + j] = nums[i * SUBGRID_SIZE + j];
-                solution[box + i][box + j] = nums[i * SUBGRID_SIZE + j];
-            }
-        }
+template <int Box>
+BasicSudoku<Box>::BasicSudoku(float difficulty, uint64_t puzzleId) :
+           grid{},
+           solution{},
+           wrong_answers{},
+           difficulty(difficulty),
+           rating(0.0f),
+           puzzleId(puzzleId),
+           score(0),
+           highlightedNumber(0),
+           highlightedVisible(false),
+           rowMask{}, colMask{}, boxMask{},
+           rowDupMask{}, colDupMask{}, boxDupMask{},
+           rowCorrect{}, colCorrect{}, boxCorrect{},
+           digitCount{},
+           filledCount(0) {
+    SUDOKU_STAT(stats = GenerationStats{});
+    generatePuzzle();
+    initializeScore();
+#ifdef SUDOKU_ENABLE_STATS
+    if (GenerationStats::isLogging()) {
+        stats.log(std::clog, "puzzle " + std::to_string(puzzleId));
     }
+#endif
+}
 
-    // Solve the rest of the grid
-    solveGrid();
-
-    // Mark all cells as fixed
+template <int Box>
+BasicSudoku<Box>::BasicSudoku(const Board& puzzle, const Board& answer, float difficulty) :
+           grid{},
+           solution{},
+           wrong_answers{},
+           difficulty(difficulty),
+           rating(0.0f),
+           puzzleId(0),
+           score(0),
+           highlightedNumber(0),
+           highlightedVisible(false),
+           rowMask{}, colMask{}, boxMask{},
+           rowDupMask{}, colDupMask{}, boxDupMask{},
+           rowCorrect{}, colCorrect{}, boxCorrect{},
+           digitCount{},
+           filledCount(0) {
+    SUDOKU_STAT(stats = GenerationStats{});
     for (int i = 0; i < GRID_SIZE; i++) {
         for (int j = 0; j < GRID_SIZE; j++) {
-            fixed[i][j] = true;
+            grid[cellIndex(i, j)] = puzzle.get(i, j);
+            solution[cellIndex(i, j)] = answer.get(i, j);
+            fixed[cellIndex(i, j)] = grid[cellIndex(i, j)] != 0;
         }
     }
-
-    // Remove some numbers to create the puzzle
-    removeCells();
+    rating = LogicalSolverType::rate(puzzle);
+    rebuildAggregates();
+    initializeScore();
 }
 
-bool Sudoku::solveGrid() {
-    int row, col;
-    
-    if (!findEmptyCell(row, col)) {
-        return true; // Puzzle is solved
-    }
-
-    std::vector<int> nums(GRID_SIZE);
-    std::iota(nums.begin(), nums.end(), 1);
+template <int Box>
+uint64_t BasicSudoku<Box>::randomPuzzleId() {
+    // Only the ID comes from the OS; everything after it is derived
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(nums.begin(), nums.end(), gen);
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
 
-    for (int num : nums) {
-        if (isValid(row, col, num)) {
-            grid[row][col] = num;
-            solution[row][col] = num;
+// Duplicate checks against PuzzleIndex::generationIndex(). Canonical forms
+// exist for 9x9 only, so every other size always counts as new.
+template <int Box>
+static bool isIndexed(const BasicBoard<Box>&) { return false; }
+template <int Box>
+static bool claimPuzzle(const BasicBoard<Box>&) { return true; }
 
-            if (solveGrid()) {
-                return true;
-            }
+static bool isIndexed(const Board& puzzle) {
+    PuzzleIndex* index = PuzzleIndex::generationIndex();
+    return index && index->contains(CanonicalForm::hash(puzzle));
+}
 
-            grid[row][col] = 0; // Backtrack
-            solution[row][col] = 0;
+// Records puzzle; false when an equivalent puzzle was already recorded
+static bool claimPuzzle(const Board& puzzle) {
+    PuzzleIndex* index = PuzzleIndex::generationIndex();
+    return !index || index->insert(CanonicalForm::hash(puzzle));
+}
+
+template <int Box>
+void BasicSudoku<Box>::generatePuzzle() {
+    float minRating, maxRating;
+    ratingRange(difficulty, minRating, maxRating);
+    Random rng(puzzleId);
+    SUDOKU_STAT_SCOPE(stats);
+    SUDOKU_STAT_TIMER(totalTimer, totalSeconds);
+
+    // Dig fresh grids until one lands in the rating window, keeping the
+    // hardest attempt in case none does. Puzzles already in the generation
+    // index, up to symmetry, are dug again.
+    bool kept = false, claimed = false;
+    Board keptPuzzle;
+    for (int attempt = 0; attempt < MAX_GENERATION_ATTEMPTS; attempt++) {
+        SUDOKU_STAT_ADD(attempts, 1);
+        Board board;
+        {
+            SUDOKU_STAT_TIMER(fillTimer, fillSeconds);
+            GridSynthesizer::fill(board, rng);
+        }
+        Board puzzle = board;
+        float achieved;
+        {
+            SUDOKU_STAT_TIMER(digTimer, digSeconds);
+            achieved = removeCells(puzzle, maxRating, rng);
         }
-    }
 
-    return false;
-}
+        // The last attempt is taken as is if every earlier one was a duplicate
+        bool accepted = achieved >= minRating;
+        bool lastChance = !kept && attempt == MAX_GENERATION_ATTEMPTS - 1;
+        if (!lastChance && (accepted ? !claimPuzzle(puzzle) : (kept && achieved <= rating) || isIndexed(puzzle))) {
+            continue;
+        }
 
-bool Sudoku::findEmptyCell(int& row, int& col) const {
-    for (row = 0; row < GRID_SIZE; row++) {
-        for (col = 0; col < GRID_SIZE; col++) {
-            if (grid[row][col] == 0) {
-                return true;
+        kept = true;
+        claimed = accepted && !lastChance;
+        keptPuzzle = puzzle;
+        rating = achieved;
+        for (int i = 0; i < GRID_SIZE; i++) {
+            for (int j = 0; j < GRID_SIZE; j++) {
+                grid[cellIndex(i, j)] = puzzle.get(i, j);
+                solution[cellIndex(i, j)] = board.get(i, j);
+                fixed[cellIndex(i, j)] = !puzzle.isEmpty(i, j);
             }
         }
+        if (accepted) break;
+    }
+    if (kept && !claimed) {
+        claimPuzzle(keptPuzzle);
     }
-    return false;
+    rebuildAggregates();
+    SUDOKU_STAT(stats.clues = static_cast<int>(fixed.count()));
+    SUDOKU_STAT(stats.rating = rating);
+    SUDOKU_STAT(stats.minRating = minRating);
+    SUDOKU_STAT(stats.maxRating = maxRating);
 }
-void Sudoku::removeCells() {
-    std::vector<std::pair<int, int>> cells;
-    for (int i = 0; i < GRID_SIZE; i++) {
-        for (int j = 0; j < GRID_SIZE; j++) {
-            cells.emplace_back(i, j);
-        }
+
+template <int Box>
+void BasicSudoku<Box>::ratingRange(float difficulty, float& minRating, float& maxRating) {
+    // Slider bands from hard to easy, each bounded by the techniques it may need
+    static const float bands[][2] = {
+        {3.4f, 7.0f},   // Subsets, fish, XY-Wing and chains
+        {2.6f, 3.2f},   // Intersections, naked pairs and X-Wings
+        {1.5f, 2.3f},   // Naked singles
+        {1.2f, 1.5f},   // Hidden singles in rows and columns
+        {0.0f, 1.2f}    // Hidden singles in boxes only
+    };
+    const int bandCount = sizeof(bands) / sizeof(bands[0]);
+    int band = std::min(static_cast<int>(difficulty * bandCount), bandCount - 1);
+    band = std::max(band, 0);
+    minRating = bands[band][0];
+    maxRating = bands[band][1];
+
+    // Forcing chains copy and propagate the whole board once per two-candidate
+    // cell, which takes seconds per puzzle past 9x9
+    if (Box > 3) {
+        maxRating = std::min(maxRating, LogicalSolverType::techniqueRating(Technique::XYWing));
+        minRating = std::min(minRating, maxRating);
     }
+}
+
+template <int Box>
+float BasicSudoku<Box>::removeCells(Board& puzzle, float maxRating, Random& rng) {
+    std::array<int, CELL_COUNT> cells;
+    std::iota(cells.begin(), cells.end(), 0);
+    rng.shuffle(cells.begin(), cells.end());
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(cells.begin(), cells.end(), gen);
-    
-    // Use difficulty slider to determine target clues
-    // Update this line:
-    float sliderValue = DifficultySettings::getDifficultySlider()->value;
-    // Interpolate between hard (20-30) and easy (40-50)
-    int minClues = static_cast<int>(20 + sliderValue * 20); // 20-40
-    int maxClues = static_cast<int>(30 + sliderValue * 20); // 30-50
-    int targetClues = minClues + (std::rand() % (maxClues - minClues + 1));
-    
-    int currentClues = GRID_SIZE * GRID_SIZE;
-    
-    // Initialize cluesPerRegion with current counts
-    std::vector<int> cluesPerRegion(9, 9);
-    std::vector<int> cluesPerRow(9, 9);    // Track clues in each row
-    std::vector<int> cluesPerCol(9, 9);    // Track clues in each column
-    
-    // Adjust minimum clues per region/row/col based on difficulty
-    int minRegionClues = static_cast<int>(2 + sliderValue * 3); // 2-5 clues per region
-    int minRowColClues = static_cast<int>(2 + sliderValue * 2); // 2-4 clues per row/col
-    
-    for (const auto& cell : cells) {
-        if (currentClues <= targetClues) break;
+    // Empty every cell that keeps the solution unique and the puzzle within
+    // reach of the techniques allowed by maxRating
+    float rating = 0.0f;
+    for (int cell : cells) {
+        int row = cell / GRID_SIZE;
+        int col = cell % GRID_SIZE;
+        int temp = puzzle.get(row, col);
         
-        int row = cell.first;
-        int col = cell.second;
-        int region = (row / 3) * 3 + (col / 3);
-        int temp = grid[row][col];
+        puzzle.remove(row, col);
         
-        if (temp == 0) continue;
-        
-        // Ensure minimum clues in regions, rows, and columns based on difficulty
-        if (cluesPerRegion[region] <= minRegionClues) continue;
-        if (cluesPerRow[row] <= minRowColClues) continue;
-        if (cluesPerCol[col] <= minRowColClues) continue;
-        
-        grid[row][col] = 0;
-        
-        // For harder difficulties (lower slider value), allow more complex solving techniques
-        int maxSolutions = (sliderValue < 0.3) ? 2 : 1; // Allow multiple solutions for hard difficulty
-        int solutions = countSolutions(0);
+        // Every deduction the logical solver makes is forced, so a puzzle it
+        // finishes has exactly one solution. On 9x9 a search for a different
+        // digit in the emptied cell is cheaper still and rules most cells out
+        // first; on the larger boards that search is what gets expensive.
+        float removedRating = LogicalSolverType::UNSOLVED_RATING;
+        if (Box > 3 || !Solver::hasAlternative(puzzle, row, col, temp)) {
+            removedRating = LogicalSolverType::rate(puzzle, maxRating);
+        }
         
-        if (solutions > maxSolutions || solutions == 0) {
-            grid[row][col] = temp;
-            fixed[row][col] = true;
+        if (removedRating <= maxRating) {
+            rating = removedRating;
         } else {
-            fixed[row][col] = false;
-            currentClues--;
-            cluesPerRegion[region]--;
-            cluesPerRow[row]--;
-            cluesPerCol[col]--;
+            puzzle.place(row, col, temp);
+            SUDOKU_STAT_ADD(rejectedRemovals, 1);
         }
     }
+    return rating;
 }
 
-// Helper method to count solutions (add this to the class)
-int Sudoku::countSolutions(int count) {
-    if (count > 1) return 2;  // We only need to know if it's not unique
-    
-    // Create a temporary grid for solution checking
-    std::vector<std::vector<int>> tempGrid = grid;
-    
-    int row, col;
-    if (!findEmptyCellInGrid(tempGrid, row, col)) return count + 1;
-    
-    for (int num = 1; num <= GRID_SIZE; num++) {
-        if (isValidInGrid(tempGrid, row, col, num)) {
-            tempGrid[row][col] = num;
-            count = countSolutionsRecursive(tempGrid, count);
-            tempGrid[row][col] = 0;
-        }
-    }
-    
-    return count;
+template <int Box>
+bool BasicSudoku<Box>::isValid(int row, int col, int num) const {
+    // A digit already sitting in this cell only clashes if it is also elsewhere in a unit
+    int box = Board::boxIndex(row, col);
+    Mask used = grid[cellIndex(row, col)] == num
+        ? (rowDupMask[row] | colDupMask[col] | boxDupMask[box])
+        : (rowMask[row] | colMask[col] | boxMask[box]);
+    return (used & Board::bit(num)) == 0;
 }
 
-// Add these helper methods
-bool Sudoku::findEmptyCellInGrid(const std::vector<std::vector<int>>& checkGrid, int& row, int& col) const {
-    for (row = 0; row < GRID_SIZE; row++) {
-        for (col = 0; col < GRID_SIZE; col++) {
-            if (checkGrid[row][col] == 0) {
-                return true;
+template <int Box>
+void BasicSudoku<Box>::rebuildAggregates() {
+    rowMask.fill(0);
+    colMask.fill(0);
+    boxMask.fill(0);
+    rowDupMask.fill(0);
+    colDupMask.fill(0);
+    boxDupMask.fill(0);
+    rowCorrect.fill(0);
+    colCorrect.fill(0);
+    boxCorrect.fill(0);
+    digitCount.fill(0);
+    filledCount = 0;
+    for (int row = 0; row < GRID_SIZE; row++) {
+        for (int col = 0; col < GRID_SIZE; col++) {
+            int num = grid[cellIndex(row, col)];
+            if (num != 0) {
+                markDigit(row, col, num);
+                countCell(row, col, num, 1);
             }
         }
     }
-    return false;
-}
 
-bool Sudoku::isValidInGrid(const std::vector<std::vector<int>>& checkGrid, int row, int col, int num) const {
-    // Check row
-    for (int x = 0; x < GRID_SIZE; x++) {
-        if (checkGrid[row][x] == num) return false;
-    }
-    
-    // Check column
-    for (int x = 0; x < GRID_SIZE; x++) {
-        if (checkGrid[x][col] == num) return false;
-    }
-    
-    // Check box
-    int startRow = row - row % SUBGRID_SIZE;
-    int startCol = col - col % SUBGRID_SIZE;
-    for (int i = 0; i < SUBGRID_SIZE; i++) {
-        for (int j = 0; j < SUBGRID_SIZE; j++) {
-            if (checkGrid[i + startRow][j + startCol] == num) return false;
+    // Conflicts need the complete masks
+    for (int row = 0; row < GRID_SIZE; row++) {
+        for (int col = 0; col < GRID_SIZE; col++) {
+            int num = grid[cellIndex(row, col)];
+            conflicts[cellIndex(row, col)] = num != 0 && !isValid(row, col, num);
         }
     }
-    
-    return true;
 }
 
-int Sudoku::countSolutionsRecursive(std::vector<std::vector<int>>& checkGrid, int count) {
-    if (count > 1) return 2;
-    
-    int row, col;
-    if (!findEmptyCellInGrid(checkGrid, row, col)) return count + 1;
-    
-    for (int num = 1; num <= GRID_SIZE; num++) {
-        if (isValidInGrid(checkGrid, row, col, num)) {
-            checkGrid[row][col] = num;
-            count = countSolutionsRecursive(checkGrid, count);
-            checkGrid[row][col] = 0;
-        }
-    }
-    
-    return count;
+// Records one more occurrence of num in the three units of (row, col)
+template <int Box>
+void BasicSudoku<Box>::markDigit(int row, int col, int num) {
+    Mask bit = Board::bit(num);
+    int box = Board::boxIndex(row, col);
+    rowDupMask[row] |= rowMask[row] & bit;
+    colDupMask[col] |= colMask[col] & bit;
+    boxDupMask[box] |= boxMask[box] & bit;
+    rowMask[row] |= bit;
+    colMask[col] |= bit;
+    boxMask[box] |= bit;
 }
-bool Sudoku::isValid(int row, int col, int num) const {
-    // Temporarily store and remove the current number
-    int currentNum = grid[row][col];
-    const_cast<Sudoku*>(this)->grid[row][col] = 0;
-
-    bool valid = isValidInRow(row, num) &&
-                isValidInCol(col, num) &&
-                isValidInBox(row - row % SUBGRID_SIZE, col - col % SUBGRID_SIZE, num);
 
-    // Restore the original number
-    const_cast<Sudoku*>(this)->grid[row][col] = currentNum;
+// Recounts num in the three units of (row, col) after it was removed from that cell
+template <int Box>
+void BasicSudoku<Box>::refreshDigit(int row, int col, int num) {
+    int startRow = row - row % SUBGRID_SIZE;
+    int startCol = col - col % SUBGRID_SIZE;
+    int inRow = 0, inCol = 0, inBox = 0;
+    for (int i = 0; i < GRID_SIZE; i++) {
+        inRow += grid[cellIndex(row, i)] == num;
+        inCol += grid[cellIndex(i, col)] == num;
+        inBox += grid[cellIndex(startRow + i / SUBGRID_SIZE, startCol + i % SUBGRID_SIZE)] == num;
+    }
 
-    return valid;
+    Mask bit = Board::bit(num);
+    int box = Board::boxIndex(row, col);
+    auto update = [bit](Mask& mask, Mask& dupMask, int count) {
+        mask = count > 0 ? (mask | bit) : (mask & ~bit);
+        dupMask = count > 1 ? (dupMask | bit) : (dupMask & ~bit);
+    };
+    update(rowMask[row], rowDupMask[row], inRow);
+    update(colMask[col], colDupMask[col], inCol);
+    update(boxMask[box], boxDupMask[box], inBox);
 }
 
-bool Sudoku::isValidInRow(int row, int num) const {
-    for (int col = 0; col < GRID_SIZE; col++) {
-        if (grid[row][col] == num) {
-            return false;
+// Re-evaluates the conflict flag of every cell holding num in the three
+// units of (row, col), after num entered or left that cell
+template <int Box>
+void BasicSudoku<Box>::refreshConflicts(int row, int col, int num) {
+    int startRow = row - row % SUBGRID_SIZE;
+    int startCol = col - col % SUBGRID_SIZE;
+    auto refresh = [this, num](int r, int c) {
+        if (grid[cellIndex(r, c)] == num) {
+            conflicts[cellIndex(r, c)] = !isValid(r, c, num);
         }
+    };
+    for (int i = 0; i < GRID_SIZE; i++) {
+        refresh(row, i);
+        refresh(i, col);
+        refresh(startRow + i / SUBGRID_SIZE, startCol + i % SUBGRID_SIZE);
     }
-    return true;
 }
 
-bool Sudoku::isValidInCol(int col, int num) const {
-    for (int row = 0; row < GRID_SIZE; row++) {
-        if (grid[row][col] == num) {
-            return false;
-        }
-    }
-    return true;
+// Which of the row, column and box of (row, col) hold num more than once, one bit each
+template <int Box>
+int BasicSudoku<Box>::duplicateUnits(int row, int col, int num) const {
+    Mask bit = Board::bit(num);
+    return ((rowDupMask[row] & bit) != 0)
+         | ((colDupMask[col] & bit) != 0) << 1
+         | ((boxDupMask[Board::boxIndex(row, col)] & bit) != 0) << 2;
 }
 
-bool Sudoku::isValidInBox(int startRow, int startCol, int num) const {
-    for (int row = 0; row < SUBGRID_SIZE; row++) {
-        for (int col = 0; col < SUBGRID_SIZE; col++) {
-            if (grid[row + startRow][col + startCol] == num) {
-                return false;
-            }
-        }
+// Adds delta copies of num at (row, col) to the digit and correct-cell counters
+template <int Box>
+void BasicSudoku<Box>::countCell(int row, int col, int num, int delta) {
+    digitCount[num - 1] += delta;
+    filledCount += delta;
+    if (num == solution[cellIndex(row, col)]) {
+        rowCorrect[row] += delta;
+        colCorrect[col] += delta;
+        boxCorrect[Board::boxIndex(row, col)] += delta;
     }
-    return true;
 }
 
-bool Sudoku::isCellEditable(int row, int col) const {
-    return !fixed[row][col];
+template <int Box>
+bool BasicSudoku<Box>::isCellEditable(int row, int col) const {
+    return !fixed[cellIndex(row, col)];
+}
+
+template <int Box>
+bool BasicSudoku<Box>::setNumber(int row, int col, int num) {
+    uint8_t effects;
+    return playMove(row, col, num, effects);
 }
 
-bool Sudoku::setNumber(int row, int col, int num) {
+template <int Box>
+bool BasicSudoku<Box>::playMove(int row, int col, int num, uint8_t& effects) {
+    effects = 0;
     if (!isCellEditable(row, col)) {
         return false;
     }
 
     totalAttempts++;
-    // Set the new value
-    grid[row][col] = num;
+    writeCell(row, col, num);
     
     if (num != 0) {
-        if (num == solution[row][col]) {
+        if (num == solution[cellIndex(row, col)]) {
             correctInputs++;
             score += 5;
+            effects |= MOVE_CORRECT;
             
             // Check for completed sections and award bonuses
-            if (!scored[row][col]) {
-                scored[row][col] = true;
-                
-                // Check row completion
-                if (isRowComplete(row)) {
-                    score += 10;
-                }
-                
-                // Check column completion
-                if (isColumnComplete(col)) {
-                    score += 10;
-                }
-                
-                // Check box completion
-                int startRow = row - (row % SUBGRID_SIZE);
-                int startCol = col - (col % SUBGRID_SIZE);
-                if (isBoxComplete(startRow, startCol)) {
-                    score += 10;
-                }
+            if (!scored[cellIndex(row, col)]) {
+                scored[cellIndex(row, col)] = true;
+                int bonuses = isRowComplete(row) + isColumnComplete(col) + isBoxComplete(Board::boxIndex(row, col));
+                score += 10 * bonuses;
+                effects |= MOVE_SCORED | bonuses << MOVE_BONUS_SHIFT;
             }
         } else {
             // Apply difficulty-based penalty for incorrect answers
             score -= getPenaltyForDifficulty();
-            wrong_answers[row][col]++;
+            effects |= MOVE_WRONG;
+            uint8_t& wrong = wrong_answers[cellIndex(row, col)];
+            if (wrong < UINT8_MAX) {
+                wrong++;
+                effects |= MOVE_WRONG_COUNTED;
+            }
         }
     }
 
     return true;
 }
 
-bool Sudoku::isRowComplete(int row) const {
-    for (int col = 0; col < GRID_SIZE; col++) {
-        if (grid[row][col] != solution[row][col]) {
-            return false;
-        }
+template <int Box>
+void BasicSudoku<Box>::revertMove(int row, int col, int previous, uint8_t effects) {
+    int cell = cellIndex(row, col);
+    totalAttempts--;
+    if (effects & MOVE_CORRECT) {
+        correctInputs--;
+        score -= 5;
     }
-    return true;
-}
-
-bool Sudoku::isColumnComplete(int col) const {
-    for (int row = 0; row < GRID_SIZE; row++) {
-        if (grid[row][col] != solution[row][col]) {
-            return false;
-        }
+    if (effects & MOVE_SCORED) {
+        scored[cell] = false;
+        score -= 10 * ((effects >> MOVE_BONUS_SHIFT) & 3);
     }
-    return true;
+    if (effects & MOVE_WRONG) {
+        score += getPenaltyForDifficulty();
+    }
+    if (effects & MOVE_WRONG_COUNTED) {
+        wrong_answers[cell]--;
+    }
+    writeCell(row, col, previous);
 }
 
-bool Sudoku::isBoxComplete(int startRow, int startCol) const {
-    for (int i = 0; i < SUBGRID_SIZE; i++) {
-        for (int j = 0; j < SUBGRID_SIZE; j++) {
-            if (grid[startRow + i][startCol + j] != solution[startRow + i][startCol + j]) {
-                return false;
-            }
-        }
+// Sets (row, col) and keeps the unit masks and counters in step
+template <int Box>
+void BasicSudoku<Box>::writeCell(int row, int col, int num) {
+    int cell = cellIndex(row, col);
+    int previous = grid[cell];
+    grid[cell] = num;
+    if (previous == num) return;
+
+    // Other cells' conflicts only change where a unit gains or loses a duplicate
+    int previousDuplicates = previous != 0 ? duplicateUnits(row, col, previous) : 0;
+    int numDuplicates = num != 0 ? duplicateUnits(row, col, num) : 0;
+    if (previous != 0) {
+        refreshDigit(row, col, previous);
+        countCell(row, col, previous, -1);
+    }
+    if (num != 0) {
+        markDigit(row, col, num);
+        countCell(row, col, num, 1);
+    }
+    conflicts[cell] = num != 0 && !isValid(row, col, num);
+    if (previous != 0 && duplicateUnits(row, col, previous) != previousDuplicates) {
+        refreshConflicts(row, col, previous);
+    }
+    if (num != 0 && duplicateUnits(row, col, num) != numDuplicates) {
+        refreshConflicts(row, col, num);
     }
-    return true;
 }
 
-int Sudoku::getPenaltyForDifficulty() const {
-    float difficulty = DifficultySettings::getDifficultySlider()->value;
+template <int Box>
+int BasicSudoku<Box>::getPenaltyForDifficulty() const {
     if (difficulty >= 0.7) { // Easy
         return 1;
     } else if (difficulty >= 0.3) { // Medium
@@ -364,74 +462,93 @@ int Sudoku::getPenaltyForDifficulty() const {
     }
 }
 
-float Sudoku::getAccuracyPercentage() const {
+template <int Box>
+float BasicSudoku<Box>::getAccuracyPercentage() const {
     if (totalAttempts == 0) return 0.0f;
     return (static_cast<float>(correctInputs) / totalAttempts) * 100.0f;
 }
 
-void Sudoku::initializeScore() {
+template <int Box>
+void BasicSudoku<Box>::initializeScore() {
     score = 0;
     correctInputs = 0;
     totalAttempts = 0;
     
-    // Initialize scored array
-    for (auto& row : scored) {
-        std::fill(row.begin(), row.end(), false);
-    }
+    // Initialize scored flags
+    scored.reset();
     
-    // Initialize wrong_answers array
-    for (auto& row : wrong_answers) {
-        std::fill(row.begin(), row.end(), 0);
-    }
+    // Initialize wrong_answers counters
+    wrong_answers.fill(0);
 }
 
-int Sudoku::getNumber(int row, int col) const {
-    return grid[row][col];
+template <int Box>
+int BasicSudoku<Box>::getNumber(int row, int col) const {
+    return grid[cellIndex(row, col)];
 }
 
-bool Sudoku::isSolved() const {
-    // Check if all cells are filled
-    for (int i = 0; i < GRID_SIZE; i++) {
-        for (int j = 0; j < GRID_SIZE; j++) {
-            if (grid[i][j] == 0) {
-                return false;
-            }
-        }
-    }
+template <int Box>
+bool BasicSudoku<Box>::isSolved() const {
+    // A full grid is solved when no row, column or box repeats a digit
+    return filledCount == CELL_COUNT && conflicts.none();
+}
 
-    // Check each row for uniqueness
-    for (int row = 0; row < GRID_SIZE; row++) {
-        std::vector<bool> used(GRID_SIZE + 1, false);
-        for (int col = 0; col < GRID_SIZE; col++) {
-            int num = grid[row][col];
-            if (used[num]) return false;
-            used[num] = true;
-        }
+static const unsigned char FLAG_FIXED = 1;
+static const unsigned char FLAG_SCORED = 2;
+
+template <int Box>
+void BasicSudoku<Box>::writeState(unsigned char* bytes) const {
+    uint32_t difficultyBits, ratingBits;
+    std::memcpy(&difficultyBits, &difficulty, sizeof(difficultyBits));
+    std::memcpy(&ratingBits, &rating, sizeof(ratingBits));
+    writeLE(bytes, difficultyBits, 4);
+    writeLE(bytes + 4, ratingBits, 4);
+    writeLE(bytes + 8, puzzleId, 8);
+    writeLE(bytes + 16, static_cast<uint32_t>(score), 4);
+    writeLE(bytes + 20, static_cast<uint32_t>(correctInputs), 4);
+    writeLE(bytes + 24, static_cast<uint32_t>(totalAttempts), 4);
+
+    unsigned char* cells = bytes + 28;
+    std::memcpy(cells, grid.data(), CELL_COUNT);
+    std::memcpy(cells + CELL_COUNT, solution.data(), CELL_COUNT);
+    std::memcpy(cells + 2 * CELL_COUNT, wrong_answers.data(), CELL_COUNT);
+    for (int cell = 0; cell < CELL_COUNT; cell++) {
+        cells[3 * CELL_COUNT + cell] = (fixed[cell] ? FLAG_FIXED : 0) | (scored[cell] ? FLAG_SCORED : 0);
     }
+}
 
-    // Check each column for uniqueness
-    for (int col = 0; col < GRID_SIZE; col++) {
-        std::vector<bool> used(GRID_SIZE + 1, false);
-        for (int row = 0; row < GRID_SIZE; row++) {
-            int num = grid[row][col];
-            if (used[num]) return false;
-            used[num] = true;
-        }
+template <int Box>
+bool BasicSudoku<Box>::readState(const unsigned char* bytes) {
+    const unsigned char* cells = bytes + 28;
+    for (int cell = 0; cell < CELL_COUNT; cell++) {
+        int num = cells[cell], answer = cells[CELL_COUNT + cell];
+        bool isFixed = (cells[3 * CELL_COUNT + cell] & FLAG_FIXED) != 0;
+        if (num > GRID_SIZE || answer < 1 || answer > GRID_SIZE || (isFixed && num != answer)) return false;
     }
 
-    // Check each 3x3 box for uniqueness
-    for (int boxRow = 0; boxRow < GRID_SIZE; boxRow += SUBGRID_SIZE) {
-        for (int boxCol = 0; boxCol < GRID_SIZE; boxCol += SUBGRID_SIZE) {
-            std::vector<bool> used(GRID_SIZE + 1, false);
-            for (int i = 0; i < SUBGRID_SIZE; i++) {
-                for (int j = 0; j < SUBGRID_SIZE; j++) {
-                    int num = grid[boxRow + i][boxCol + j];
-                    if (used[num]) return false;
-                    used[num] = true;
-                }
-            }
-        }
+    uint32_t difficultyBits = static_cast<uint32_t>(readLE(bytes, 4));
+    uint32_t ratingBits = static_cast<uint32_t>(readLE(bytes + 4, 4));
+    std::memcpy(&difficulty, &difficultyBits, sizeof(difficulty));
+    std::memcpy(&rating, &ratingBits, sizeof(rating));
+    puzzleId = readLE(bytes + 8, 8);
+    score = static_cast<int32_t>(readLE(bytes + 16, 4));
+    correctInputs = static_cast<int32_t>(readLE(bytes + 20, 4));
+    totalAttempts = static_cast<int32_t>(readLE(bytes + 24, 4));
+
+    std::memcpy(grid.data(), cells, CELL_COUNT);
+    std::memcpy(solution.data(), cells + CELL_COUNT, CELL_COUNT);
+    std::memcpy(wrong_answers.data(), cells + 2 * CELL_COUNT, CELL_COUNT);
+    for (int cell = 0; cell < CELL_COUNT; cell++) {
+        fixed[cell] = (cells[3 * CELL_COUNT + cell] & FLAG_FIXED) != 0;
+        scored[cell] = (cells[3 * CELL_COUNT + cell] & FLAG_SCORED) != 0;
     }
-
+    highlightedNumber = 0;
+    highlightedVisible = false;
+    SUDOKU_STAT(stats = GenerationStats{});
+    rebuildAggregates();
     return true;
-}
\ No newline at end of file
+}
+
+template class BasicSudoku<2>;
+template class BasicSudoku<3>;
+template class BasicSudoku<4>;
+template class BasicSudoku<5>;
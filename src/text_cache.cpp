@@ -0,0 +1,67 @@
+#include "text_cache.h"
+#include <functional>
+
+TextCache::TextCache(std::size_t byteBudget)
+    : budget(byteBudget), bytes(0), hits(0), misses(0), evictions(0) {}
+
+TextCache::~TextCache() {
+    clear();
+}
+
+std::size_t TextCache::KeyHash::operator()(const Key& key) const {
+    std::size_t hash = std::hash<std::string>()(key.text);
+    hash ^= std::hash<const void*>()(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint64_t>()((static_cast<uint64_t>(key.color) << 32) | static_cast<uint32_t>(key.style)) +
+            0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+const TextCache::Entry* TextCache::get(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color) {
+    if (!font || text.empty()) return nullptr;
+
+    Key key{font, TTF_GetFontStyle(font),
+            static_cast<uint32_t>(color.r) << 24 | static_cast<uint32_t>(color.g) << 16 |
+            static_cast<uint32_t>(color.b) << 8 | color.a,
+            text};
+    auto found = index.find(key);
+    if (found != index.end()) {
+        hits++;
+        entries.splice(entries.begin(), entries, found->second);
+        return &found->second->entry;
+    }
+
+    misses++;
+    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
+    if (!surface) return nullptr;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    Node node{key, {texture, surface->w, surface->h}, static_cast<std::size_t>(surface->w) * surface->h * 4};
+    SDL_FreeSurface(surface);
+    if (!texture) return nullptr;
+
+    entries.push_front(node);
+    index.emplace(key, entries.begin());
+    bytes += node.bytes;
+    // The new entry stays even when it alone is over budget
+    while (bytes > budget && entries.size() > 1) {
+        evictLast();
+    }
+    return &entries.front().entry;
+}
+
+void TextCache::clear() {
+    for (Node& node : entries) {
+        SDL_DestroyTexture(node.entry.texture);
+    }
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+void TextCache::evictLast() {
+    Node& node = entries.back();
+    SDL_DestroyTexture(node.entry.texture);
+    bytes -= node.bytes;
+    index.erase(node.key);
+    entries.pop_back();
+    evictions++;
+}
@@ -0,0 +1,376 @@
+// Benchmark suite. Times puzzle generation per difficulty bucket, solution
+// counting on a fixed corpus, batch solving at the scalar and SIMD levels,
+// setNumber/isSolved throughput and, when built with SUDOKU_BENCH_RENDER, a
+// full Renderer::render frame under SDL's offscreen video driver. Prints a
+// table and writes the same numbers as JSON.
+#include "sudoku.h"
+#include "solver.h"
+#include "batch_solver.h"
+#include "puzzle_bank.h"
+#include "move_journal.h"
+#ifdef SUDOKU_BENCH_RENDER
+#include "renderer.h"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct BenchOptions {
+    int samples = 20;   // Puzzles per difficulty bucket; the other groups scale from it
+    std::string json;
+    std::string replay;  // Captured session to replay, see SUDOKU_JOURNAL
+};
+
+// One timed operation and its samples
+struct BenchResult {
+    std::string name;
+    std::string unit;
+    std::vector<double> samples;
+};
+
+struct CorpusPuzzle {
+    const char* name;
+    const char* cells;  // 81 characters, '.' or '0' for an empty cell
+};
+
+// Fixed solving corpus: everyday puzzles, well-known hard ones, a minimal
+// 17-clue puzzle, a grid built to defeat naive backtracking and an empty
+// board (many solutions, so counting stops at the limit)
+static const CorpusPuzzle CORPUS[] = {
+    {"easy", "..3.2.6..9..3.5..1..18.64....81.29..7.......8..67.82....26.95..8..2.3..9..5.1.3.."},
+    {"hard", "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......"},
+    {"inkala", "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4.."},
+    {"golden_nugget", ".......39.....1..5..3.5.8....8.9...6.7...2...1..4.......9.8..5..2....6..4..7....."},
+    {"17_clue", ".......1.4.........2...........5.4.7..8...3....1.9....3..4..2...5.1........8.6..."},
+    {"anti_backtracking", "..............3.85..1.2.......5.7.....4...1...9.......5......73..2.1........4...9"},
+    {"empty", "................................................................................."}
+};
+
+static double elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool parseBoard(const char* cells, Board& board) {
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        char c = cells[cell];
+        if (c == '\0') return false;
+        if (c < '1' || c > '9') continue;
+        int row = cell / Board::SIZE, col = cell % Board::SIZE;
+        if (!board.canPlace(row, col, c - '0')) return false;
+        board.place(row, col, c - '0');
+    }
+    return true;
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    std::size_t rank = static_cast<std::size_t>(fraction * sorted.size() + 0.999999);
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+static bool parseArgs(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--samples" && hasValue) {
+            options.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            options.json = argv[++i];
+        } else if (arg == "--replay" && hasValue) {
+            options.replay = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Generation per difficulty bucket, from fixed puzzle IDs so every run digs
+// the same puzzles
+static void benchGeneration(const BenchOptions& options, std::vector<BenchResult>& results) {
+    for (int bucket = 0; bucket < PuzzleBank::BUCKETS; bucket++) {
+        BenchResult result{"generate/bucket" + std::to_string(bucket), "ms", {}};
+        float difficulty = PuzzleBank::bucketDifficulty(bucket);
+        for (int i = 0; i < options.samples; i++) {
+            auto start = std::chrono::steady_clock::now();
+            Sudoku sudoku(difficulty, static_cast<uint64_t>(bucket) * 1000003u + i);
+            result.samples.push_back(elapsed(start) * 1e3);
+        }
+        results.push_back(result);
+    }
+}
+
+static void benchSolving(const BenchOptions& options, std::vector<BenchResult>& results) {
+    const SolverBackend backends[] = {SolverBackend::Backtracking, SolverBackend::DancingLinks};
+    SolverBackend previous = Solver::getBackend();
+    for (const CorpusPuzzle& puzzle : CORPUS) {
+        Board board;
+        if (!parseBoard(puzzle.cells, board)) {
+            std::cerr << "Corpus puzzle " << puzzle.name << " is malformed" << std::endl;
+            continue;
+        }
+        for (SolverBackend backend : backends) {
+            Solver::setBackend(backend);
+            BenchResult result{std::string("count_solutions/") + Solver::backendName(backend) + "/" + puzzle.name, "us", {}};
+            for (int i = 0; i < options.samples * 5; i++) {
+                auto start = std::chrono::steady_clock::now();
+                Solver::countSolutions(board, 2);
+                result.samples.push_back(elapsed(start) * 1e6);
+            }
+            results.push_back(result);
+        }
+    }
+    Solver::setBackend(previous);
+}
+
+// Puzzle of a generated game: its givens only
+static Board givens(const Sudoku& sudoku) {
+    Board board;
+    for (int row = 0; row < Board::SIZE; row++) {
+        for (int col = 0; col < Board::SIZE; col++) {
+            if (!sudoku.isCellEditable(row, col)) {
+                board.place(row, col, sudoku.getNumber(row, col));
+            }
+        }
+    }
+    return board;
+}
+
+// Batch solving at the scalar level and at the CPU's SIMD level, on a batch of
+// generated puzzles (one solution each) and on the corpus, repeated to the
+// same batch size. Samples are per puzzle; the levels must agree on every count.
+static void benchBatch(const BenchOptions& options, std::vector<BenchResult>& results) {
+    const std::size_t BATCH = 64;
+    std::vector<Board> generated, corpus;
+    for (std::size_t i = 0; i < BATCH; i++) {
+        generated.push_back(givens(Sudoku(PuzzleBank::bucketDifficulty(i % PuzzleBank::BUCKETS), 7000003u + i)));
+        Board board;
+        if (parseBoard(CORPUS[i % (sizeof(CORPUS) / sizeof(CORPUS[0]))].cells, board)) {
+            corpus.push_back(board);
+        }
+    }
+
+    SimdLevel levels[] = {SimdLevel::Scalar, BatchSolver::detectSimdLevel()};
+    int levelCount = levels[1] == SimdLevel::Scalar ? 1 : 2;
+    for (const std::vector<Board>* batch : {&generated, &corpus}) {
+        std::vector<BatchResult> reference;
+        for (int level = 0; level < levelCount; level++) {
+            BenchResult result{std::string("batch_solve/") + BatchSolver::simdLevelName(levels[level]) +
+                               (batch == &generated ? "/generated" : "/corpus"), "us", {}};
+            std::vector<BatchResult> solved(batch->size());
+            for (int i = 0; i < options.samples; i++) {
+                auto start = std::chrono::steady_clock::now();
+                BatchSolver::solve(batch->data(), solved.data(), batch->size(), levels[level]);
+                result.samples.push_back(elapsed(start) * 1e6 / batch->size());
+            }
+            if (level == 0) {
+                reference = solved;
+            }
+            for (std::size_t i = 0; i < solved.size(); i++) {
+                if (solved[i].solutionCount != reference[i].solutionCount) {
+                    std::cerr << result.name << ": puzzle " << i << " has " << solved[i].solutionCount
+                              << " solutions, scalar found " << reference[i].solutionCount << std::endl;
+                }
+            }
+            results.push_back(result);
+        }
+    }
+}
+
+// Player input: every sample fills all empty cells with the right digit,
+// checks the board after each one as the game does, and clears them again
+static void benchPlay(const BenchOptions& options, std::vector<BenchResult>& results) {
+    Sudoku sudoku(0.0f, 1);
+    std::vector<int> empty;
+    for (int cell = 0; cell < Sudoku::CELL_COUNT; cell++) {
+        if (sudoku.isCellEditable(cell / Sudoku::GRID_SIZE, cell % Sudoku::GRID_SIZE)) empty.push_back(cell);
+    }
+
+    BenchResult setResult{"set_number", "ns", {}};
+    BenchResult solvedResult{"is_solved", "ns", {}};
+    int solvedCount = 0;
+    for (int i = 0; i < options.samples * 10; i++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int cell : empty) {
+            int row = cell / Sudoku::GRID_SIZE, col = cell % Sudoku::GRID_SIZE;
+            sudoku.setNumber(row, col, sudoku.getSolution(row, col));
+        }
+        for (int cell : empty) {
+            sudoku.setNumber(cell / Sudoku::GRID_SIZE, cell % Sudoku::GRID_SIZE, 0);
+        }
+        setResult.samples.push_back(elapsed(start) * 1e9 / (2 * empty.size()));
+
+        for (int cell : empty) {
+            int row = cell / Sudoku::GRID_SIZE, col = cell % Sudoku::GRID_SIZE;
+            sudoku.setNumber(row, col, sudoku.getSolution(row, col));
+        }
+        start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < 100; repeat++) {
+            solvedCount += sudoku.isSolved();
+        }
+        solvedResult.samples.push_back(elapsed(start) * 1e9 / 100);
+        for (int cell : empty) {
+            sudoku.setNumber(cell / Sudoku::GRID_SIZE, cell % Sudoku::GRID_SIZE, 0);
+        }
+    }
+    if (solvedCount == 0) std::cerr << "is_solved never saw the solved board" << std::endl;
+    results.push_back(setResult);
+    results.push_back(solvedResult);
+}
+
+// Save files: encoding the game on the frame thread and restoring it at launch
+static void benchSave(const BenchOptions& options, std::vector<BenchResult>& results) {
+    Sudoku sudoku(0.5f, 1);
+    std::vector<unsigned char> bytes(Sudoku::STATE_SIZE);
+    BenchResult encodeResult{"save/encode", "ns", {}};
+    BenchResult restoreResult{"save/restore", "ns", {}};
+    int restoredCount = 0;
+    for (int i = 0; i < options.samples * 10; i++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < 100; repeat++) {
+            sudoku.writeState(bytes.data());
+        }
+        encodeResult.samples.push_back(elapsed(start) * 1e9 / 100);
+
+        start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < 100; repeat++) {
+            Sudoku restored;
+            restoredCount += restored.readState(bytes.data());
+        }
+        restoreResult.samples.push_back(elapsed(start) * 1e9 / 100);
+    }
+    if (restoredCount != options.samples * 1000) std::cerr << "Saved game does not restore" << std::endl;
+    results.push_back(encodeResult);
+    results.push_back(restoreResult);
+}
+
+// A captured session played back at full speed, per move
+template <int Box>
+static void replaySession(const BenchOptions& options, MoveJournal& journal, std::vector<BenchResult>& results) {
+    BasicSudoku<Box> start;
+    if (!journal.startingBoard(start) || journal.size() == 0) return;
+    BenchResult result{"replay/moves", "ns", {}};
+    for (int i = 0; i < options.samples * 10; i++) {
+        BasicSudoku<Box> board = start;
+        auto begin = std::chrono::steady_clock::now();
+        if (!journal.replay(board)) {
+            std::cerr << "Session does not replay on its own starting board" << std::endl;
+            return;
+        }
+        result.samples.push_back(elapsed(begin) * 1e9 / journal.size());
+    }
+    results.push_back(result);
+}
+
+static void benchReplay(const BenchOptions& options, std::vector<BenchResult>& results) {
+    MoveJournal journal;
+    if (!journal.load(options.replay)) {
+        std::cerr << "Cannot read session " << options.replay << std::endl;
+        return;
+    }
+    switch (journal.getBoxSize()) {
+        case 2: replaySession<2>(options, journal, results); break;
+        case 3: replaySession<3>(options, journal, results); break;
+        case 4: replaySession<4>(options, journal, results); break;
+        case 5: replaySession<5>(options, journal, results); break;
+    }
+}
+
+#ifdef SUDOKU_BENCH_RENDER
+// Whole frames as the game draws them, on SDL's offscreen driver unless
+// SDL_VIDEODRIVER already picks one
+static void benchRender(const BenchOptions& options, std::vector<BenchResult>& results) {
+    SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    Renderer renderer;
+    if (!renderer.init()) {
+        std::cerr << "Renderer could not start, skipping frame benchmark: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    Sudoku sudoku(0.5f, 1);
+    BenchResult result{"render/frame", "us", {}};
+    for (int i = 0; i < 10; i++) {
+        renderer.render(sudoku, 4, 4);  // Warm-up: textures, glyph caches
+    }
+    for (int i = 0; i < options.samples * 10; i++) {
+        auto start = std::chrono::steady_clock::now();
+        renderer.render(sudoku, i % 2 ? 4 : -1, i % 2 ? 4 : -1);
+        result.samples.push_back(elapsed(start) * 1e6);
+    }
+    results.push_back(result);
+
+    const TextCache& textCache = renderer.getTextCache();
+    std::cout << "Text cache: " << textCache.getHits() << " hits, " << textCache.getMisses() << " misses, "
+              << textCache.size() << " textures in " << textCache.getBytes() / 1024 << " KiB" << std::endl;
+}
+#endif
+
+static bool writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n"
+        << "  \"version\": 1,\n"
+        << "  \"simd\": \"" << BatchSolver::simdLevelName(BatchSolver::detectSimdLevel()) << "\",\n"
+        << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        out << "    {\"name\": \"" << result.name << "\", \"unit\": \"" << result.unit
+            << "\", \"samples\": " << result.samples.size()
+            << ", \"p50\": " << percentile(result.samples, 0.50)
+            << ", \"p99\": " << percentile(result.samples, 0.99)
+            << ", \"max\": " << (result.samples.empty() ? 0.0 : result.samples.back())
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--samples N] [--json FILE] [--replay SESSION]\n"
+                  << "  --samples N   puzzles per difficulty bucket; other groups scale from it (default 20)\n"
+                  << "  --json FILE   also write the results as JSON to FILE\n"
+                  << "  --replay SESSION  also time replaying a session captured with SUDOKU_JOURNAL\n";
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    benchGeneration(options, results);
+    benchSolving(options, results);
+    benchBatch(options, results);
+    benchPlay(options, results);
+    benchSave(options, results);
+    if (!options.replay.empty()) {
+        benchReplay(options, results);
+    }
+#ifdef SUDOKU_BENCH_RENDER
+    benchRender(options, results);
+#endif
+
+    std::cout << std::left << std::setw(48) << "benchmark" << std::right
+              << std::setw(8) << "unit" << std::setw(12) << "p50" << std::setw(12) << "p99"
+              << std::setw(12) << "max" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (BenchResult& result : results) {
+        std::sort(result.samples.begin(), result.samples.end());
+        std::cout << std::left << std::setw(48) << result.name << std::right
+                  << std::setw(8) << result.unit
+                  << std::setw(12) << percentile(result.samples, 0.50)
+                  << std::setw(12) << percentile(result.samples, 0.99)
+                  << std::setw(12) << (result.samples.empty() ? 0.0 : result.samples.back()) << std::endl;
+    }
+
+    if (!options.json.empty() && !writeJson(options.json, results)) {
+        std::cerr << "Cannot write " << options.json << std::endl;
+        return 1;
+    }
+    return 0;
+}
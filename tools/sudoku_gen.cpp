@@ -0,0 +1,295 @@
+// Headless bulk puzzle generator. Writes one puzzle per line in the standard
+// 81-character format ('.' for an empty cell) and reports per-thread rates.
+// With --bank it instead fills every difficulty bucket of a puzzle bank file.
+#include "sudoku.h"
+#include "puzzle_bank.h"
+#include "solver.h"
+#include "grid_synthesizer.h"
+#include "puzzle_index.h"
+#include "generation_stats.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct GenOptions {
+    long count = 100;
+    float difficulty = 0.5f;
+    unsigned threads = 0;
+    std::string output;
+    std::string bank;
+    bool seeded = false;
+    uint64_t seed = 0;
+    long benchGrids = 0;
+    bool dedup = false;
+    bool stats = false;
+    std::string countPuzzle;
+    uint64_t limit = 1000000;
+};
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  -n, --count N         number of puzzles to generate (default 100)\n"
+              << "  -d, --difficulty D    slider value from 0 (hard) to 1 (easy) (default 0.5)\n"
+              << "  -t, --threads T       worker threads (default: all cores)\n"
+              << "  -o, --output FILE     write puzzles to FILE instead of stdout\n"
+              << "      --seed ID         give puzzle i the ID ID + i, making the run reproducible\n"
+              << "      --solver NAME     backtracking or dlx\n"
+              << "      --grids SOURCE    where solution grids come from: backtracking or transform\n"
+              << "      --bench-grids N   time N solution grids from each source and exit\n"
+              << "      --dedup           never emit two puzzles that are the same up to symmetry\n"
+              << "      --stats           log generation stats per puzzle and on average (STATS=1 builds)\n"
+              << "      --bank FILE       write a puzzle bank with N puzzles per difficulty bucket\n"
+              << "      --count-solutions PUZZLE\n"
+              << "                        count the solutions of an 81-character puzzle on all threads and exit\n"
+              << "      --limit N         stop counting at N solutions (default 1000000)\n";
+}
+
+static bool parseArgs(int argc, char** argv, GenOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ((arg == "-n" || arg == "--count") && hasValue) {
+            options.count = std::atol(argv[++i]);
+        } else if ((arg == "-d" || arg == "--difficulty") && hasValue) {
+            options.difficulty = static_cast<float>(std::atof(argv[++i]));
+        } else if ((arg == "-t" || arg == "--threads") && hasValue) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            options.output = argv[++i];
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 0);
+            options.seeded = true;
+        } else if (arg == "--bank" && hasValue) {
+            options.bank = argv[++i];
+        } else if (arg == "--solver" && hasValue) {
+            SolverBackend backend;
+            if (!Solver::parseBackend(argv[++i], backend)) {
+                std::cerr << "Unknown solver '" << argv[i] << "'" << std::endl;
+                return false;
+            }
+            Solver::setBackend(backend);
+        } else if (arg == "--grids" && hasValue) {
+            GridSource source;
+            if (!GridSynthesizer::parseSource(argv[++i], source)) {
+                std::cerr << "Unknown grid source '" << argv[i] << "'" << std::endl;
+                return false;
+            }
+            GridSynthesizer::setSource(source);
+        } else if (arg == "--dedup") {
+            options.dedup = true;
+        } else if (arg == "--count-solutions" && hasValue) {
+            options.countPuzzle = argv[++i];
+        } else if (arg == "--limit" && hasValue) {
+            options.limit = std::strtoull(argv[++i], nullptr, 0);
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--bench-grids" && hasValue) {
+            options.benchGrids = std::atol(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    if (options.limit == 0) {
+        std::cerr << "Limit must be at least 1" << std::endl;
+        return false;
+    }
+    if (options.stats && !GenerationStats::ENABLED) {
+        std::cerr << "--stats needs a build with STATS=1" << std::endl;
+        return false;
+    }
+    if (options.count <= 0 || options.difficulty < 0.0f || options.difficulty > 1.0f) {
+        std::cerr << "Count must be positive and difficulty within 0-1" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static std::string formatPuzzle(const Sudoku& sudoku) {
+    std::string line(Sudoku::GRID_SIZE * Sudoku::GRID_SIZE, '.');
+    for (int row = 0; row < Sudoku::GRID_SIZE; row++) {
+        for (int col = 0; col < Sudoku::GRID_SIZE; col++) {
+            int num = sudoku.getNumber(row, col);
+            if (num != 0) {
+                line[row * Sudoku::GRID_SIZE + col] = static_cast<char>('0' + num);
+            }
+        }
+    }
+    return line;
+}
+
+static BankEntry makeBankEntry(const Sudoku& sudoku, int bucket) {
+    BankEntry entry{bucket, Board(), Board()};
+    for (int row = 0; row < Sudoku::GRID_SIZE; row++) {
+        for (int col = 0; col < Sudoku::GRID_SIZE; col++) {
+            if (sudoku.getNumber(row, col) != 0) {
+                entry.puzzle.place(row, col, sudoku.getNumber(row, col));
+            }
+            entry.solution.place(row, col, sudoku.getSolution(row, col));
+        }
+    }
+    return entry;
+}
+
+// Reads an 81-character puzzle, '.' or '0' for an empty cell. False when it
+// is malformed or two clues clash, which leaves it with no solutions.
+static bool parsePuzzle(const std::string& cells, Board& board) {
+    if (cells.size() != static_cast<std::size_t>(Board::CELLS)) return false;
+    for (int cell = 0; cell < Board::CELLS; cell++) {
+        char c = cells[cell];
+        if (c == '.' || c == '0') continue;
+        int row = cell / Board::SIZE, col = cell % Board::SIZE;
+        if (c < '1' || c > '9' || !board.canPlace(row, col, c - '0')) return false;
+        board.place(row, col, c - '0');
+    }
+    return true;
+}
+
+static int countPuzzleSolutions(const GenOptions& options) {
+    Board board;
+    if (!parsePuzzle(options.countPuzzle, board)) {
+        std::cerr << "Puzzle must be 81 characters of 1-9, '.' or '0' without clashing clues" << std::endl;
+        return 1;
+    }
+    ThreadPool pool(options.threads);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t count = Solver::countSolutionsParallel(board, options.limit, pool);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << count << (count == options.limit ? "+" : "") << std::endl;
+    std::cerr << std::fixed << std::setprecision(3) << "counted in " << seconds << " s on "
+              << pool.size() << " threads" << (count == options.limit ? ", limit reached" : "") << std::endl;
+    return 0;
+}
+
+// Times count complete 9x9 grids from each source on one thread
+static void benchmarkGrids(long count) {
+    std::cout << std::fixed;
+    for (GridSource source : {GridSource::Backtracking, GridSource::Transform}) {
+        GridSynthesizer::setSource(source);
+        Random rng(1);
+        Board board;
+        GridSynthesizer::fill(board, rng);  // Builds the seed library outside the timing
+
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < count; i++) {
+            GridSynthesizer::fill(board, rng);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(14) << std::left << GridSynthesizer::sourceName(source)
+                  << std::setprecision(3) << count << " grids in " << seconds << " s, "
+                  << std::setprecision(1) << (seconds > 0 ? count / seconds : 0.0) << " grids/sec" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    GenOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!options.countPuzzle.empty()) {
+        return countPuzzleSolutions(options);
+    }
+    if (options.benchGrids > 0) {
+        benchmarkGrids(options.benchGrids);
+        return 0;
+    }
+
+    bool bankMode = !options.bank.empty();
+    long total = bankMode ? options.count * PuzzleBank::BUCKETS : options.count;
+
+    std::ofstream file;
+    if (!bankMode && !options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "Cannot open " << options.output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    GenerationStats::setLogging(options.stats);
+
+    PuzzleIndex index(options.dedup ? static_cast<std::size_t>(total) : 0);
+    if (options.dedup) {
+        PuzzleIndex::setGenerationIndex(&index);
+    }
+
+    std::vector<std::string> puzzles(bankMode ? 0 : total);
+    std::vector<BankEntry> entries(bankMode ? total : 0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<long> generated;
+    std::vector<double> busySeconds;
+    std::vector<GenerationStats> stats;
+    {
+        ThreadPool pool(options.threads);
+        generated.assign(pool.size(), 0);
+        busySeconds.assign(pool.size(), 0.0);
+        stats.assign(pool.size(), GenerationStats{});
+
+        for (long i = 0; i < total; i++) {
+            pool.submit([&, i] {
+                auto taskStart = std::chrono::steady_clock::now();
+                int bucket = bankMode ? static_cast<int>(i / options.count) : 0;
+                float difficulty = bankMode ? PuzzleBank::bucketDifficulty(bucket) : options.difficulty;
+                Sudoku sudoku = options.seeded ? Sudoku(difficulty, options.seed + static_cast<uint64_t>(i))
+                                               : Sudoku(difficulty);
+                if (bankMode) {
+                    entries[i] = makeBankEntry(sudoku, bucket);
+                } else {
+                    puzzles[i] = formatPuzzle(sudoku);
+                }
+                int worker = pool.currentWorker();
+                generated[worker]++;
+                busySeconds[worker] += std::chrono::duration<double>(std::chrono::steady_clock::now() - taskStart).count();
+                SUDOKU_STAT(stats[worker].merge(sudoku.getGenerationStats()));
+            });
+        }
+        pool.wait();
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (bankMode) {
+        if (!PuzzleBank::write(options.bank, entries)) {
+            std::cerr << "Cannot write " << options.bank << std::endl;
+            return 1;
+        }
+    } else {
+        for (const auto& puzzle : puzzles) {
+            out << puzzle << '\n';
+        }
+        out.flush();
+    }
+
+    std::cerr << std::fixed << std::setprecision(1);
+    for (std::size_t worker = 0; worker < generated.size(); worker++) {
+        double rate = busySeconds[worker] > 0 ? generated[worker] / busySeconds[worker] : 0.0;
+        std::cerr << "thread " << worker << ": " << generated[worker] << " puzzles, "
+                  << rate << " puzzles/sec" << std::endl;
+    }
+    std::cerr << "total: " << total << " puzzles in " << std::setprecision(3) << wallSeconds << " s, "
+              << std::setprecision(1) << (wallSeconds > 0 ? total / wallSeconds : 0.0)
+              << " puzzles/sec" << std::endl;
+    if (options.stats && total > 0) {
+        GenerationStats sum{};
+        for (const GenerationStats& workerStats : stats) {
+            sum.merge(workerStats);
+        }
+        double n = static_cast<double>(total);
+        std::cerr << "stats per puzzle: " << sum.clues / n << " clues, " << sum.attempts / n << " attempts, "
+                  << sum.nodeVisits / n << " nodes, " << sum.backtracks / n << " backtracks, "
+                  << sum.solutionCounts / n << " solution counts, " << sum.ratings / n << " ratings, "
+                  << sum.rejectedRemovals / n << " rejected removals, " << std::setprecision(3)
+                  << "fill " << sum.fillSeconds * 1e3 / n << " ms, dig " << sum.digSeconds * 1e3 / n << " ms" << std::endl;
+    }
+    if (options.dedup) {
+        std::cerr << "dedup: " << index.size() << " distinct puzzles indexed, "
+                  << index.duplicates() << " duplicates dug again" << std::endl;
+    }
+    return 0;
+}